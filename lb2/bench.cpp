@@ -0,0 +1,335 @@
+// Бенчмарк алгоритмов задачи коммивояжера из solution.cpp.
+//
+// Сборка:  g++ -std=c++17 -O2 -o bench bench.cpp
+//          (с -DTELEMETRY дополнительно пишется telemetry.json, см. solution.cpp)
+// Запуск:  ./bench [seed] [файл[:лучшая_стоимость] ...] > results.csv
+//
+// Генерирует экземпляры с фиксированным зерном (симметричные и несимметричные,
+// метрические, неметрические и разреженные) для набора размеров, дополнительно читает
+// эталонные экземпляры из файлов в формате входа solution.cpp. Для каждого
+// экземпляра и алгоритма печатает строку CSV: время, число раскрытых вершин,
+// пиковый размер очереди и стоимость тура относительно лучшей известной.
+// Для небольших экземпляров дополнительно сравнивается повторное решение
+// после изменения нескольких стоимостей с нуля и с сохраненного фронта.
+
+#define main solutionMain
+#include "solution.cpp"
+#undef main
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <random>
+
+// Размеры, на которых еще запускается точный алгоритм Литтла
+const int MAX_LITTLE_SIZE = 12;
+const int MAX_LITTLE_SYMMETRIC_SIZE = 30;
+const long long LITTLE_NODE_LIMIT = 200000;
+// Разреженный вариант: вершина дерева дешевле, но экземпляры крупнее
+const int MAX_LITTLE_SPARSE_SIZE = 200;
+const long long LITTLE_SPARSE_NODE_LIMIT = 20000;
+// Число ближайших соседей, с которыми связан город в разреженных экземплярах
+const int SPARSE_NEIGHBORS = 4;
+// Размеры, для которых лучшая стоимость вычисляется динамикой Хелда-Карпа
+const int MAX_HELD_KARP_SIZE = 13;
+
+struct Instance {
+    string name;
+    string kind;
+    unsigned seed = 0;
+    vector<vector<double>> input;  // Матрица в формате входа (-1 - нет ребра)
+    double bestKnown = -1;         // Лучшая известная стоимость (-1 - неизвестна)
+};
+
+// Случайные точки на плоскости, расстояния округляются до целых
+vector<pair<float, float>> randomPoints(int n, mt19937& rng) {
+    uniform_real_distribution<float> coord(0, 1000);
+    vector<pair<float, float>> points(n);
+    for (auto& p : points) p = {coord(rng), coord(rng)};
+    return points;
+}
+
+Instance generateInstance(const string& kind, int n, unsigned seed) {
+    mt19937 rng(seed);
+    Instance inst;
+    inst.name = kind + "-" + to_string(n) + "-" + to_string(seed);
+    inst.kind = kind;
+    inst.seed = seed;
+    inst.input.assign(n, vector<double>(n, -1));
+    auto& c = inst.input;
+
+    if (kind == "asym-sparse") {
+        // Дорожная сеть: ребра только к ближайшим соседям (в обе стороны) и
+        // вдоль случайного гамильтонова цикла, чтобы тур существовал
+        vector<pair<float, float>> points = randomPoints(n, rng);
+        auto dist = [&](int i, int j) {
+            return round(hypot(points[i].first - points[j].first, points[i].second - points[j].second));
+        };
+        for (int i = 0; i < n; i++) {
+            vector<int> order;
+            for (int j = 0; j < n; j++) if (j != i) order.push_back(j);
+            int k = min<int>(SPARSE_NEIGHBORS, order.size());
+            partial_sort(order.begin(), order.begin() + k, order.end(),
+                         [&](int a, int b) { return dist(i, a) < dist(i, b); });
+            for (int t = 0; t < k; t++) c[i][order[t]] = c[order[t]][i] = dist(i, order[t]);
+        }
+
+        vector<int> cycle(n);
+        for (int i = 0; i < n; i++) cycle[i] = i;
+        shuffle(cycle.begin(), cycle.end(), rng);
+        for (int i = 0; i < n; i++) c[cycle[i]][cycle[(i + 1) % n]] = dist(cycle[i], cycle[(i + 1) % n]);
+
+        // Одностороннее движение: часть ребер вне цикла убирается
+        uniform_int_distribution<int> coin(0, 3);
+        vector<vector<bool>> onCycle(n, vector<bool>(n, false));
+        for (int i = 0; i < n; i++) onCycle[cycle[i]][cycle[(i + 1) % n]] = true;
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                if (c[i][j] >= 0 && !onCycle[i][j] && coin(rng) == 0) c[i][j] = -1;
+    } else if (kind == "sym-metric" || kind == "asym-metric") {
+        vector<pair<float, float>> points = randomPoints(n, rng);
+        // Высоты для несимметричного варианта: подъем стоит дороже спуска,
+        // неравенство треугольника при этом сохраняется
+        uniform_real_distribution<float> height(0, 300);
+        vector<float> h(n);
+        for (auto& v : h) v = height(rng);
+
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                if (i == j) continue;
+                double d = hypot(points[i].first - points[j].first, points[i].second - points[j].second);
+                if (kind == "asym-metric") d += max(0.0f, h[j] - h[i]);
+                c[i][j] = round(d);
+            }
+        }
+    } else {
+        uniform_int_distribution<int> cost(1, 1000);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                if (i == j) continue;
+                if (kind == "sym-random" && j < i) c[i][j] = c[j][i];
+                else c[i][j] = cost(rng);
+            }
+        }
+    }
+
+    return inst;
+}
+
+// Точное решение динамикой по подмножествам для небольших n
+template <typename Cost>
+Cost heldKarp(const vector<vector<Cost>>& c) {
+    int n = c.size();
+    if (n == 1) return 0;
+
+    int full = 1 << (n - 1);
+    vector<Cost> dp((size_t)full * (n - 1), INF<Cost>);
+    for (int v = 1; v < n; v++) {
+        dp[(size_t)(1 << (v - 1)) * (n - 1) + v - 1] = c[0][v];
+    }
+
+    for (int mask = 1; mask < full; mask++) {
+        for (int last = 1; last < n; last++) {
+            Cost cur = dp[(size_t)mask * (n - 1) + last - 1];
+            if (cur == INF<Cost> || !(mask & (1 << (last - 1)))) continue;
+            for (int next = 1; next < n; next++) {
+                if (mask & (1 << (next - 1))) continue;
+                Cost& cell = dp[(size_t)(mask | (1 << (next - 1))) * (n - 1) + next - 1];
+                cell = min(cell, addCost(cur, c[last][next]));
+            }
+        }
+    }
+
+    Cost best = INF<Cost>;
+    for (int last = 1; last < n; last++) {
+        best = min(best, addCost(dp[(size_t)(full - 1) * (n - 1) + last - 1], c[last][0]));
+    }
+    return best;
+}
+
+struct RunResult {
+    string engine;
+    double timeMs = 0;
+    SearchStats stats;
+    double cost = -1; // -1 - тур не найден
+};
+
+template <typename Cost>
+RunResult runEngine(const string& engine, const function<vector<int>(SearchStats&)>& solve,
+                    const vector<vector<Cost>>& costMatrix) {
+    RunResult result;
+    result.engine = engine;
+    result.stats.nodeLimit = LITTLE_NODE_LIMIT;
+
+    auto start = chrono::steady_clock::now();
+    vector<int> path = solve(result.stats);
+    auto finish = chrono::steady_clock::now();
+
+    result.timeMs = chrono::duration<double, milli>(finish - start).count();
+    if (path.size() == costMatrix.size() && calculateTotalCost(path, costMatrix) != INF<Cost>)
+        result.cost = calculateTotalCost(path, costMatrix);
+    return result;
+}
+
+void printResult(const Instance& inst, int n, const string& costType, const RunResult& r) {
+    cout << inst.name << ',' << inst.kind << ',' << n << ',' << inst.seed << ',' << costType << ','
+         << r.engine << ',' << fixed << setprecision(3) << r.timeMs << ','
+         << r.stats.nodesExpanded << ',' << r.stats.peakQueueSize << ','
+         << setprecision(3) << r.stats.allocationsPerExpansion() << ','
+         << (r.stats.limitReached ? "limit" : "ok") << ',';
+    if (r.cost >= 0) cout << setprecision(1) << r.cost;
+    cout << ',';
+    if (inst.bestKnown >= 0) cout << setprecision(1) << inst.bestKnown;
+    cout << ',';
+    if (r.cost >= 0 && inst.bestKnown > 0)
+        cout << setprecision(4) << r.cost / inst.bestKnown;
+    cout << endl;
+}
+
+// Повторное решение после небольшого изменения матрицы: два ребра
+// оптимального тура дорожают на 10%, одно случайное ребро дешевеет на 10%.
+// Сравнивается решение измененной матрицы с нуля и продолжение поиска
+// с фронта, сохраненного после решения исходной матрицы.
+template <typename Cost>
+void benchmarkWarmStart(const Instance& inst, const vector<vector<Cost>>& c, const string& costType) {
+    int n = c.size();
+    IncrementalLittleSolver<Cost> warmSolver(c);
+    SearchStats initialStats;
+    initialStats.nodeLimit = LITTLE_NODE_LIMIT;
+    vector<pair<int, int>> tour = warmSolver.solve(&initialStats);
+    if (tour.empty()) return;
+
+    mt19937 rng(inst.seed);
+    auto changed = [](Cost cost, int sign) {
+        Cost delta = max<Cost>(cost / 10, 1);
+        return sign > 0 ? addCost(cost, delta) : max<Cost>(cost - delta, 0);
+    };
+    vector<CostUpdate<Cost>> updates;
+    for (int k = 0; k < 2; k++) {
+        auto edge = tour[rng() % tour.size()];
+        updates.push_back({edge.first, edge.second, changed(c[edge.first][edge.second], 1)});
+    }
+    int from = rng() % n, to = (from + 1 + rng() % (n - 1)) % n;
+    if (c[from][to] != INF<Cost>) updates.push_back({from, to, changed(c[from][to], -1)});
+
+    vector<vector<Cost>> updated = c;
+    for (const auto& u : updates) updated[u.from][u.to] = u.cost;
+
+    Instance updatedInst = inst;
+    updatedInst.name = inst.name + "-updated";
+    updatedInst.bestKnown = -1;
+    if (n <= MAX_HELD_KARP_SIZE && heldKarp(updated) != INF<Cost>) updatedInst.bestKnown = heldKarp(updated);
+
+    printResult(updatedInst, n, costType, runEngine("little-incremental-cold", [&](SearchStats& stats) {
+        IncrementalLittleSolver<Cost> coldSolver(updated);
+        return edgesToPath(coldSolver.solve(&stats), n);
+    }, updated));
+    printResult(updatedInst, n, costType, runEngine("little-warm-start", [&](SearchStats& stats) {
+        return edgesToPath(warmSolver.update(updates, &stats), n);
+    }, updated));
+}
+
+template <typename Cost>
+void benchmarkInstance(Instance& inst, const vector<vector<Cost>>& c, const string& costType) {
+    int n = c.size();
+    vector<RunResult> results;
+
+    results.push_back(runEngine("nearest-neighbor", [&](SearchStats&) {
+        return nearestNeighborAlgorithm(c);
+    }, c));
+
+    if (n <= MAX_LITTLE_SIZE) {
+        results.push_back(runEngine("little", [&](SearchStats& stats) {
+            return edgesToPath(littleAlgorithm(c, &stats), n);
+        }, c));
+    }
+
+    if (n <= MAX_LITTLE_SPARSE_SIZE && isSparse(c)) {
+        results.push_back(runEngine("little-sparse", [&](SearchStats& stats) {
+            stats.nodeLimit = LITTLE_SPARSE_NODE_LIMIT;
+            return edgesToPath(littleSparseAlgorithm(c, &stats), n);
+        }, c));
+    }
+
+    if (n <= MAX_LITTLE_SYMMETRIC_SIZE && isSymmetric(c)) {
+        results.push_back(runEngine("little-symmetric", [&](SearchStats& stats) {
+            return edgesToPath(littleSymmetricAlgorithm(c, &stats), n);
+        }, c));
+    }
+
+    results.push_back(runEngine("local-search", [&](SearchStats&) {
+        return localSearchAlgorithm(c);
+    }, c));
+
+    if (inst.bestKnown < 0 && n <= MAX_HELD_KARP_SIZE && heldKarp(c) != INF<Cost>) inst.bestKnown = heldKarp(c);
+    if (inst.bestKnown < 0) {
+        for (const auto& r : results) {
+            if (r.cost >= 0 && (inst.bestKnown < 0 || r.cost < inst.bestKnown)) inst.bestKnown = r.cost;
+        }
+    }
+
+    for (const auto& r : results) printResult(inst, n, costType, r);
+
+    if (n <= MAX_LITTLE_SIZE) benchmarkWarmStart(inst, c, costType);
+}
+
+// Запуск на матрице того же типа стоимостей, что выбрал бы solution.cpp
+void benchmarkInstance(Instance& inst) {
+    const char* names[] = {"int32", "int64", "double"};
+    string costType = names[(int)chooseCostType(inst.input)];
+
+    dispatchCostType(inst.input, [&](auto costMatrix) {
+        using Cost = typename decltype(costMatrix)::value_type::value_type;
+        for (size_t i = 0; i < costMatrix.size(); i++) costMatrix[i][i] = INF<Cost>;
+        benchmarkInstance(inst, costMatrix, costType);
+        return 0;
+    });
+}
+
+// Эталонный экземпляр: файл в формате входа solution.cpp, после двоеточия
+// можно указать лучшую известную стоимость
+bool loadInstance(const string& spec, Instance& inst) {
+    string path = spec;
+    size_t colon = spec.rfind(':');
+    if (colon != string::npos) {
+        path = spec.substr(0, colon);
+        inst.bestKnown = stod(spec.substr(colon + 1));
+    }
+
+    ifstream in(path);
+    if (!in) return false;
+
+    inst.name = path;
+    inst.kind = "reference";
+    inst.input = readCostMatrix(in);
+    return !in.fail() && !inst.input.empty();
+}
+
+int main(int argc, char* argv[]) {
+    DEBUG = false;
+    TELEMETRY_WRITE_AT_EXIT();
+
+    unsigned seed = argc > 1 ? stoul(argv[1]) : 1;
+    const vector<string> kinds = {"sym-metric", "sym-random", "asym-metric", "asym-random", "asym-sparse"};
+    const vector<int> sizes = {6, 8, 10, 12, 20, 30, 50, 200, 1000};
+
+    cout << "instance,kind,n,seed,cost_type,engine,time_ms,nodes_expanded,peak_queue,allocs_per_node,status,cost,best_known,ratio" << endl;
+
+    for (const string& kind : kinds) {
+        for (int n : sizes) {
+            Instance inst = generateInstance(kind, n, seed);
+            benchmarkInstance(inst);
+        }
+    }
+
+    for (int i = 2; i < argc; i++) {
+        Instance inst;
+        if (!loadInstance(argv[i], inst)) {
+            cerr << "Не удалось прочитать экземпляр: " << argv[i] << endl;
+            continue;
+        }
+        benchmarkInstance(inst);
+    }
+
+    return 0;
+}
@@ -3,37 +3,362 @@
 #include <queue>
 #include <limits>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <memory>
+#include <sstream>
+#include <map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
 
 using namespace std;
 
-const float INF = numeric_limits<float>::max();
+// Стоимость отсутствующего ребра; сложение с ней насыщается (см. addCost)
+template <typename Cost>
+const Cost INF = numeric_limits<Cost>::max();
 
+// Сложение стоимостей без переполнения: результат не превышает INF
+template <typename Cost>
+Cost addCost(Cost a, Cost b) {
+    if (a == INF<Cost> || b == INF<Cost>) return INF<Cost>;
+    if (b > 0 && a > INF<Cost> - b) return INF<Cost>;
+    return a + b;
+}
+
+bool DEBUG = true; // Подробный вывод хода алгоритмов в консоль
+
+// Статистика поиска алгоритма Литтла
+struct SearchStats {
+    long long nodesExpanded = 0; // Число раскрытых вершин дерева решений
+    size_t peakQueueSize = 0;    // Максимальный размер очереди с приоритетом
+    long long nodeLimit = 0;     // Ограничение на число раскрытых вершин (0 - без ограничения)
+    bool limitReached = false;   // Поиск остановлен по ограничению
+    long long allocations = 0;   // Обращения к системному аллокатору за буферами вершин
+    long long nodesRevalidated = 0; // Вершины, пересчитанные после изменения стоимостей
+
+    double allocationsPerExpansion() const {
+        return nodesExpanded ? (double)allocations / nodesExpanded : 0;
+    }
+};
+
+// Телеметрия поиска: сборка с -DTELEMETRY. Счетчики и время фаз каждого
+// запуска поиска пишутся в JSON-файл (путь из переменной окружения
+// LB2_TELEMETRY, по умолчанию telemetry.json) при завершении программы.
+// Без флага макросы раскрываются в пустоту и ничего не стоят.
+#ifdef TELEMETRY
+#include <chrono>
+#include <fstream>
+#include <cstdlib>
+
+struct SearchTelemetry {
+    // Точка кривой сходимости: лучшая нижняя граница и рекорд на момент времени
+    struct Sample {
+        double timeMs;
+        long long nodes;
+        double bound, incumbent;   // NaN - неизвестно
+    };
+
+    string algorithm;
+    int n = 0;
+    long long nodesExpanded = 0;
+    long long nodesPruned = 0;       // Отброшенные вершины: подцикл, граница, тупик
+    long long includeBranches = 0;
+    long long excludeBranches = 0;
+    size_t queueHighWater = 0;
+    long long reduceNs = 0, mstNs = 0, branchingNs = 0;
+    double bound = NAN, incumbent = NAN;
+    // Рекорд известен во время поиска. Варианты little и little-sparse
+    // получают единственный тур при выходе, а их граница с MST не является
+    // нижней, поэтому разрыв для них не пишется
+    bool incumbentDuringSearch = false;
+    chrono::steady_clock::time_point start;
+    vector<Sample> samples;
+
+    void sample() {
+        double timeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        samples.push_back({timeMs, nodesExpanded, bound, incumbent});
+    }
+};
+
+// Каждый поток пакетного режима ведет свой запуск
+thread_local SearchTelemetry telemetry;
+mutex telemetryMutex;
+vector<string> telemetryRuns;
+
+const long long TELEMETRY_SAMPLE_EVERY = 1024;
+
+template <typename Cost>
+double telemetryValue(Cost value) {
+    return value == INF<Cost> ? NAN : (double)value;
+}
+
+string telemetryNumber(double value) {
+    if (std::isnan(value)) return "null";
+    ostringstream out;
+    out << setprecision(15) << value;
+    return out.str();
+}
+
+// Запуск поиска: начинается при создании, записывается при выходе из области
+struct TelemetryRun {
+    TelemetryRun(const char* algorithm, int n) {
+        telemetry = SearchTelemetry();
+        telemetry.algorithm = algorithm;
+        telemetry.n = n;
+        telemetry.start = chrono::steady_clock::now();
+    }
+
+    ~TelemetryRun() {
+        telemetry.sample();
+        const SearchTelemetry& t = telemetry;
+        ostringstream json;
+        json << "{\"algorithm\":\"" << t.algorithm << "\",\"n\":" << t.n
+             << ",\"nodes_expanded\":" << t.nodesExpanded << ",\"nodes_pruned\":" << t.nodesPruned
+             << ",\"include_branches\":" << t.includeBranches << ",\"exclude_branches\":" << t.excludeBranches
+             << ",\"queue_high_water\":" << t.queueHighWater
+             << ",\"time_ns\":{\"reduce\":" << t.reduceNs << ",\"mst\":" << t.mstNs
+             << ",\"branching\":" << t.branchingNs << "},\"samples\":[";
+        for (size_t k = 0; k < t.samples.size(); k++) {
+            const auto& s = t.samples[k];
+            json << (k ? "," : "") << "{\"time_ms\":" << telemetryNumber(s.timeMs) << ",\"nodes\":" << s.nodes
+                 << ",\"bound\":" << telemetryNumber(s.bound) << ",\"incumbent\":" << telemetryNumber(s.incumbent);
+            if (t.incumbentDuringSearch) json << ",\"gap\":" << telemetryNumber((s.incumbent - s.bound) / s.incumbent);
+            json << "}";
+        }
+        json << "]}";
+
+        lock_guard<mutex> lock(telemetryMutex);
+        telemetryRuns.push_back(json.str());
+    }
+};
+
+template <typename Cost>
+void telemetryExpand(Cost bound, size_t queueSize) {
+    telemetry.nodesExpanded++;
+    telemetry.queueHighWater = max(telemetry.queueHighWater, queueSize);
+    telemetry.bound = telemetryValue(bound);
+    if (telemetry.nodesExpanded % TELEMETRY_SAMPLE_EVERY == 0) telemetry.sample();
+}
+
+template <typename Cost>
+void telemetryIncumbent(const vector<pair<int, int>>& tour, const vector<vector<Cost>>& costMatrix) {
+    Cost cost = 0;
+    for (const auto& edge : tour) cost = addCost(cost, costMatrix[edge.first][edge.second]);
+    telemetry.incumbent = telemetryValue(cost);
+}
+
+template <typename F>
+auto telemetryTimed(long long& totalNs, F f) {
+    auto start = chrono::steady_clock::now();
+    auto result = f();
+    totalNs += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void writeTelemetry() {
+    const char* path = getenv("LB2_TELEMETRY");
+    ofstream out(path ? path : "telemetry.json");
+    out << "{\"runs\":[";
+    for (size_t k = 0; k < telemetryRuns.size(); k++) out << (k ? ",\n" : "\n") << telemetryRuns[k];
+    out << "\n]}\n";
+}
+
+#define TELEMETRY_RUN(algorithm, n) TelemetryRun telemetryRun(algorithm, n)
+#define TELEMETRY_EXPAND(bound, queueSize) telemetryExpand(bound, queueSize)
+#define TELEMETRY_COUNT(counter) (telemetry.counter++)
+#define TELEMETRY_TIMED(phaseNs, expr) telemetryTimed(telemetry.phaseNs, [&] { return expr; })
+#define TELEMETRY_INCUMBENT(tour, costMatrix) telemetryIncumbent(tour, costMatrix)
+#define TELEMETRY_INCUMBENT_COST(cost) (telemetry.incumbentDuringSearch = true, telemetry.incumbent = telemetryValue(cost))
+// Очередь исчерпана: рекорд доказанно оптимален
+#define TELEMETRY_PROVEN() (telemetry.bound = telemetry.incumbent)
+#define TELEMETRY_WRITE_AT_EXIT() atexit(writeTelemetry)
+#else
+// Пустые операторы, а не пустота: вызов остается телом if без -Wempty-body
+#define TELEMETRY_RUN(algorithm, n) do {} while (0)
+#define TELEMETRY_EXPAND(bound, queueSize) ((void)0)
+#define TELEMETRY_COUNT(counter) ((void)0)
+#define TELEMETRY_TIMED(phaseNs, expr) (expr)
+#define TELEMETRY_INCUMBENT(tour, costMatrix) ((void)0)
+#define TELEMETRY_INCUMBENT_COST(cost) ((void)0)
+#define TELEMETRY_PROVEN() ((void)0)
+#define TELEMETRY_WRITE_AT_EXIT() ((void)0)
+#endif
+
+// Матрица n x n, хранящаяся одним блоком; память принадлежит NodePool
+template <typename Cost>
+struct MatrixView {
+    Cost* data = nullptr;
+    int n = 0;
+
+    int size() const { return n; }
+    Cost* operator[](int i) const { return data + (size_t)i * n; }
+};
+
+template <typename Cost>
 struct State {
-    vector<vector<float>> costMatrix; // Матрица стоимостей
+    MatrixView<Cost> costMatrix;      // Матрица стоимостей
     vector<pair<int, int>> included;  // Список включенных ребер
     vector<pair<int, int>> excluded;  // Список исключенных ребер
-    float lowerBound;                 // Нижняя граница стоимости решения
+    Cost lowerBound;                 // Нижняя граница стоимости решения
     
-    State(const vector<vector<float>>& matrix, 
-          const vector<pair<int, int>>& inc = {}, 
-          const vector<pair<int, int>>& exc = {}, 
-          float lb = 0) : costMatrix(matrix), included(inc), excluded(exc), lowerBound(lb) {}
+    State(MatrixView<Cost> matrix, 
+          vector<pair<int, int>> inc = {}, 
+          vector<pair<int, int>> exc = {}, 
+          Cost lb = 0) : costMatrix(matrix), included(move(inc)), excluded(move(exc)), lowerBound(lb) {}
     
     bool operator>(const State& other) const {
         return lowerBound > other.lowerBound;
     }
 };
 
+// Пул буферов для вершин дерева решений алгоритма Литтла. Матрицы выделяются
+// блоками n x n из крупных участков памяти, размер которых растет вдвое, а
+// матрицы и списки ребер извлеченных из очереди или отсеченных вершин
+// возвращаются в пул и переиспользуются. Разреженный и симметричный варианты
+// берут из пула массивы стоимостей и массивы по вершинам. Счетчик allocations
+// показывает, сколько раз пришлось обратиться к системному аллокатору
+template <typename Cost>
+class NodePool {
+public:
+    explicit NodePool(int n) : n(n), blockSize((size_t)n * n) {}
+
+    // Подготовка к экземпляру размера n: выделенные ранее блоки
+    // переиспользуются, если в них помещается матрица n×n
+    void reset(int newN) {
+        n = newN;
+        freeMatrices.clear();
+        if ((size_t)n * n > blockSize) {
+            slabs.clear();
+            slabBlocks = 0;
+            blockSize = (size_t)n * n;
+        }
+
+        size_t blocks = 16;
+        for (const auto& slab : slabs) {
+            for (size_t b = 0; b < blocks; b++) freeMatrices.push_back(slab.get() + b * blockSize);
+            blocks *= 2;
+        }
+    }
+
+    MatrixView<Cost> copyMatrix(MatrixView<Cost> source) {
+        MatrixView<Cost> matrix = acquireMatrix();
+        copy(source.data, source.data + (size_t)n * n, matrix.data);
+        return matrix;
+    }
+
+    MatrixView<Cost> copyMatrix(const vector<vector<Cost>>& source) {
+        MatrixView<Cost> matrix = acquireMatrix();
+        for (int i = 0; i < n; i++) copy(source[i].begin(), source[i].end(), matrix[i]);
+        return matrix;
+    }
+
+    // Копия списка ребер с запасом хотя бы под одно новое ребро и не меньше
+    // чем под n ребер, чтобы тур достраивался без расширения
+    vector<pair<int, int>> copyEdges(const vector<pair<int, int>>& source) {
+        vector<pair<int, int>> edges;
+        if (!freeEdges.empty()) {
+            edges = move(freeEdges.back());
+            freeEdges.pop_back();
+        }
+        if (edges.capacity() < max<size_t>(source.size() + 1, n)) {
+            allocations++;
+            edges.reserve(max<size_t>(2 * source.size(), n));
+        }
+        edges.assign(source.begin(), source.end());
+        return edges;
+    }
+
+    // Добавление ребра в список из пула с учетом возможного расширения
+    void appendEdge(vector<pair<int, int>>& edges, pair<int, int> edge) {
+        if (edges.size() == edges.capacity()) allocations++;
+        edges.push_back(edge);
+    }
+
+    void release(State<Cost>& state) {
+        freeMatrices.push_back(state.costMatrix.data);
+        state.costMatrix.data = nullptr;
+        releaseEdges(state.included);
+        releaseEdges(state.excluded);
+    }
+
+    // Буферы вершин разреженного и симметричного вариантов: массивы
+    // стоимостей ребер и массивы по вершинам графа. Новый буфер заполнен нулями
+    vector<Cost> acquireCosts(size_t size) { return acquireArray(freeCosts, size); }
+    vector<int> acquireIndices(size_t size) { return acquireArray(freeIndices, size); }
+
+    vector<Cost> copyCosts(const vector<Cost>& source) {
+        vector<Cost> costs = acquireCosts(source.size());
+        copy(source.begin(), source.end(), costs.begin());
+        return costs;
+    }
+
+    vector<int> copyIndices(const vector<int>& source) {
+        vector<int> indices = acquireIndices(source.size());
+        copy(source.begin(), source.end(), indices.begin());
+        return indices;
+    }
+
+    void releaseCosts(vector<Cost>& costs) { freeCosts.push_back(move(costs)); }
+    void releaseIndices(vector<int>& indices) { freeIndices.push_back(move(indices)); }
+    void releaseEdges(vector<pair<int, int>>& edges) { freeEdges.push_back(move(edges)); }
+
+    long long allocations = 0;
+
+private:
+    template <typename T>
+    vector<T> acquireArray(vector<vector<T>>& freeList, size_t size) {
+        vector<T> array;
+        if (!freeList.empty()) {
+            array = move(freeList.back());
+            freeList.pop_back();
+        }
+        array.clear();
+        if (array.capacity() < size) allocations++;
+        array.resize(size);
+        return array;
+    }
+
+    MatrixView<Cost> acquireMatrix() {
+        if (freeMatrices.empty()) {
+            size_t blocks = slabs.empty() ? 16 : 2 * slabBlocks;
+            slabs.emplace_back(new Cost[blocks * blockSize]);
+            slabBlocks = blocks;
+            allocations++;
+            for (size_t b = 0; b < blocks; b++) freeMatrices.push_back(slabs.back().get() + b * blockSize);
+        }
+
+        Cost* data = freeMatrices.back();
+        freeMatrices.pop_back();
+        return {data, n};
+    }
+
+    int n;
+    size_t blockSize;   // Размер блока под матрицу; не меньше n×n
+    size_t slabBlocks = 0;
+    vector<unique_ptr<Cost[]>> slabs;
+    vector<Cost*> freeMatrices;
+    vector<vector<pair<int, int>>> freeEdges;
+    vector<vector<Cost>> freeCosts;
+    vector<vector<int>> freeIndices;
+};
+
 
 // Функция для вывода матрицы стоимостей
-void printMatrix(const vector<vector<float>>& matrix, const string& title) {
+template <typename Cost>
+void printMatrix(MatrixView<Cost> matrix, const string& title) {
     cout << title << ":" << endl;
-    for (const auto& row : matrix) {
-        for (float val : row) {
-            if (val == INF)
+    for (int i = 0; i < matrix.size(); i++) {
+        for (int j = 0; j < matrix.size(); j++) {
+            Cost val = matrix[i][j];
+            if (val == INF<Cost>)
                 cout << "INF ";
             else
-                cout << fixed << setprecision(1) << val << " ";
+                cout << fixed << setprecision(1) << (double)val << " ";
         }
         cout << endl;
     }
@@ -41,12 +366,13 @@ void printMatrix(const vector<vector<float>>& matrix, const string& title) {
 }
 
 // Алгоритм ближайшего соседа для поиска начального решения
-vector<int> nearestNeighborAlgorithm(const vector<vector<float>>& costMatrix) {
+template <typename Cost>
+vector<int> nearestNeighborAlgorithm(const vector<vector<Cost>>& costMatrix) {
     int n = costMatrix.size();
     int startVertex = 0;
     
-    cout << "\n--- Выполнение алгоритма ближайшего соседа (АБС) ---" << endl;
-    cout << "Начальная вершина: " << startVertex << endl;
+    if (DEBUG) cout << "\n--- Выполнение алгоритма ближайшего соседа (АБС) ---" << endl;
+    if (DEBUG) cout << "Начальная вершина: " << startVertex << endl;
     
     vector<int> path;
     vector<bool> visited(n, false);
@@ -55,26 +381,26 @@ vector<int> nearestNeighborAlgorithm(const vector<vector<float>>& costMatrix) {
     path.push_back(currentVertex);
     visited[currentVertex] = true;
     
-    cout << "Путь: " << currentVertex;
+    if (DEBUG) cout << "Путь: " << currentVertex;
     
     for (int i = 0; i < n - 1; i++) {
-        float minDist = INF;
+        Cost minDist = INF<Cost>;
         int nextVertex = -1;
 
         // Ищем ближайшую непосещенную вершину
         for (int j = 0; j < n; j++) {
-            if (!visited[j] && costMatrix[currentVertex][j] < minDist && costMatrix[currentVertex][j] < INF) {
+            if (!visited[j] && costMatrix[currentVertex][j] < minDist && costMatrix[currentVertex][j] < INF<Cost>) {
                 minDist = costMatrix[currentVertex][j];
                 nextVertex = j;
             }
         }
 
         if (nextVertex == -1) {
-            cout << "\nНет доступного пути к следующей вершине" << endl;
+            if (DEBUG) cout << "\nНет доступного пути к следующей вершине" << endl;
             return {};
         }
         
-        cout << " -> " << nextVertex << " (стоимость: " << minDist << ")";
+        if (DEBUG) cout << " -> " << nextVertex << " (стоимость: " << (double)minDist << ")";
         
         currentVertex = nextVertex;
         path.push_back(currentVertex);
@@ -82,26 +408,27 @@ vector<int> nearestNeighborAlgorithm(const vector<vector<float>>& costMatrix) {
     }
 
     // Возвращаемся в начальную вершину
-    if (costMatrix[currentVertex][startVertex] == INF) {
-        cout << "\nНет пути обратно к начальной вершине" << endl;
+    if (costMatrix[currentVertex][startVertex] == INF<Cost>) {
+        if (DEBUG) cout << "\nНет пути обратно к начальной вершине" << endl;
         return {};
     }
     
-    cout << " -> " << startVertex << " (стоимость: " << costMatrix[currentVertex][startVertex] << ")" << endl;
-    cout << "--- Завершение АБС ---\n" << endl;
+    if (DEBUG) cout << " -> " << startVertex << " (стоимость: " << (double)costMatrix[currentVertex][startVertex] << ")" << endl;
+    if (DEBUG) cout << "--- Завершение АБС ---\n" << endl;
     
     return path;
 }
 
 
 // Редукция матрицы
-float reduceMatrix(vector<vector<float>>& matrix) {
+template <typename Cost>
+Cost reduceMatrix(MatrixView<Cost> matrix) {
     int n = matrix.size();
-    float reduction = 0;    // Нижняя граница
+    Cost reduction = 0;    // Нижняя граница
     
     // Редукция строк
     for (int i = 0; i < n; i++) {
-        float minVal = INF;
+        Cost minVal = INF<Cost>;
         for (int j = 0; j < n; j++) {
             if (matrix[i][j] < minVal) {
                 minVal = matrix[i][j];
@@ -109,32 +436,32 @@ float reduceMatrix(vector<vector<float>>& matrix) {
         }
         
         // Если минимальное значение меньше бесконечности, то вычитаем его из всех элементов строки
-        if (minVal < INF) {
+        if (minVal < INF<Cost>) {
             for (int j = 0; j < n; j++) {
-                if (matrix[i][j] < INF) {
+                if (matrix[i][j] < INF<Cost>) {
                     matrix[i][j] -= minVal;
                 }
             }
-            reduction += minVal;
+            reduction = addCost(reduction, minVal);
         }
     }
     
     // Редукция столбцов
     for (int j = 0; j < n; j++) {
-        float minVal = INF;
+        Cost minVal = INF<Cost>;
         for (int i = 0; i < n; i++) {
             if (matrix[i][j] < minVal) {
                 minVal = matrix[i][j];
             }
         }
         
-        if (minVal < INF) {
+        if (minVal < INF<Cost>) {
             for (int i = 0; i < n; i++) {
-                if (matrix[i][j] < INF) {
+                if (matrix[i][j] < INF<Cost>) {
                     matrix[i][j] -= minVal;
                 }
             }
-            reduction += minVal;
+            reduction = addCost(reduction, minVal);
         }
     }
     
@@ -142,15 +469,16 @@ float reduceMatrix(vector<vector<float>>& matrix) {
 }
 
 // Функция для поиска ребра для ветвления (ребро с максимальной суммой минимальных элементов в строке и столбце)
-pair<int, int> findBranchingEdge(const vector<vector<float>>& matrix) {
+template <typename Cost>
+pair<int, int> findBranchingEdge(MatrixView<Cost> matrix) {
     int n = matrix.size();
-    float maxCost = -1;
+    Cost maxCost = -1;
     pair<int, int> edge = {-1, -1};
     
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < n; j++) {
             if (matrix[i][j] == 0) {
-                float rowMin2 = INF, colMin2 = INF;
+                Cost rowMin2 = INF<Cost>, colMin2 = INF<Cost>;
                 
                 // Ищем второй минимальный элемент в строке
                 for (int k = 0; k < n; k++) {
@@ -160,10 +488,10 @@ pair<int, int> findBranchingEdge(const vector<vector<float>>& matrix) {
                         colMin2 = matrix[k][j];
                 }
                 
-                if (rowMin2 == INF) rowMin2 = 0;
-                if (colMin2 == INF) colMin2 = 0;
+                if (rowMin2 == INF<Cost>) rowMin2 = 0;
+                if (colMin2 == INF<Cost>) colMin2 = 0;
                 
-                float cost = rowMin2 + colMin2;
+                Cost cost = rowMin2 + colMin2;
                 if (cost > maxCost) {
                     maxCost = cost;
                     edge = {i, j};
@@ -209,7 +537,8 @@ bool hasCycle(const vector<pair<int, int>>& edges, const pair<int, int>& newEdge
 }
 
 // Функция для вычисления нижней границы на основе минимального остовного дерева (MST)
-float calculateMSTBound(const vector<vector<float>>& matrix) {
+template <typename Cost>
+Cost calculateMSTBound(MatrixView<Cost> matrix) {
     int n = matrix.size();
 
     if (n <= 2) return 0;
@@ -217,7 +546,7 @@ float calculateMSTBound(const vector<vector<float>>& matrix) {
     const int excludedVertex = 0; // Исключаем вершину 0 из MST
 
     vector<bool> visited(n, false);
-    vector<float> minEdge(n, INF);
+    vector<Cost> minEdge(n, INF<Cost>);
     visited[excludedVertex] = true;
 
     int startVertex = 1;
@@ -228,11 +557,11 @@ float calculateMSTBound(const vector<vector<float>>& matrix) {
     }
     visited[startVertex] = true;
     
-    float mstWeight = 0;
+    Cost mstWeight = 0;
 
     for (int i = 0; i < n-2; i++) {
         int nextVertex = -1;
-        float minWeight = INF;
+        Cost minWeight = INF<Cost>;
         
         for (int j = 0; j < n; j++) {
             if (!visited[j] && minEdge[j] < minWeight) {
@@ -241,10 +570,10 @@ float calculateMSTBound(const vector<vector<float>>& matrix) {
             }
         }
         
-        if (nextVertex == -1 || minWeight == INF) break;
+        if (nextVertex == -1 || minWeight == INF<Cost>) break;
         
         visited[nextVertex] = true;
-        mstWeight += minWeight;
+        mstWeight = addCost(mstWeight, minWeight);
 
         for (int j = 0; j < n; j++) {
             if (!visited[j] && matrix[nextVertex][j] < minEdge[j]) {
@@ -253,7 +582,7 @@ float calculateMSTBound(const vector<vector<float>>& matrix) {
         }
     }
 
-    float min1 = INF, min2 = INF;
+    Cost min1 = INF<Cost>, min2 = INF<Cost>;
     for (int i = 1; i < n; i++) {
         if (matrix[excludedVertex][i] < min1) {
             min2 = min1;
@@ -264,50 +593,79 @@ float calculateMSTBound(const vector<vector<float>>& matrix) {
         }
     }
     
-    if (min1 < INF) mstWeight += min1;
-    if (min2 < INF) mstWeight += min2;
+    if (min1 < INF<Cost>) mstWeight = addCost(mstWeight, min1);
+    if (min2 < INF<Cost>) mstWeight = addCost(mstWeight, min2);
     
     return mstWeight;
 }
 
-vector<pair<int, int>> littleAlgorithm(vector<vector<float>> costMatrix) {
+template <typename Cost>
+vector<pair<int, int>> littleAlgorithm(vector<vector<Cost>> costMatrix, SearchStats* stats = nullptr,
+                                       NodePool<Cost>* sharedPool = nullptr) {
     int n = costMatrix.size();
     
-    cout << "\n--- Выполнение алгоритма Литтла ---" << endl;
+    if (DEBUG) cout << "\n--- Выполнение алгоритма Литтла ---" << endl;
 
     // Запрещаем петли
     for (int i = 0; i < n; i++) {
-        costMatrix[i][i] = INF;
+        costMatrix[i][i] = INF<Cost>;
     }
     
-    cout << "Начальная матрица стоимости:" << endl;
-    printMatrix(costMatrix, "Исходная матрица");
+    // Пул буферов вершин: собственный или переданный вызывающим, чтобы
+    // переиспользовать память между экземплярами
+    NodePool<Cost> ownPool(0);
+    NodePool<Cost>& pool = sharedPool ? *sharedPool : ownPool;
+    pool.reset(n);
+    long long allocationsBefore = pool.allocations;
+    MatrixView<Cost> rootMatrix = pool.copyMatrix(costMatrix);
+    TELEMETRY_RUN("little", n);
+    
+    if (DEBUG) cout << "Начальная матрица стоимости:" << endl;
+    if (DEBUG) printMatrix(rootMatrix, "Исходная матрица");
 
-    float reduction = reduceMatrix(costMatrix);
-    cout << "Значение редукции матрицы: " << reduction << endl;
+    Cost reduction = TELEMETRY_TIMED(reduceNs, reduceMatrix(rootMatrix));
+    if (DEBUG) cout << "Значение редукции матрицы: " << (double)reduction << endl;
     
-    printMatrix(costMatrix, "Матрица после редукции");
+    if (DEBUG) printMatrix(rootMatrix, "Матрица после редукции");
 
-    float mstBound = calculateMSTBound(costMatrix);
-    float startLowerBound = reduction + mstBound;
-    cout << "Начальная нижняя граница: " << startLowerBound << endl;
+    Cost mstBound = TELEMETRY_TIMED(mstNs, calculateMSTBound(rootMatrix));
+    Cost startLowerBound = addCost(reduction, mstBound);
+    if (DEBUG) cout << "Начальная нижняя граница: " << (double)startLowerBound << endl;
 
-    priority_queue<State, vector<State>, greater<State>> pq;
-    pq.push(State(costMatrix, {}, {}, startLowerBound));
+    // Очередь с приоритетом на куче поверх vector: в отличие от priority_queue
+    // верхнюю вершину можно переместить, а не копировать
+    vector<State<Cost>> pq;
+    auto pushState = [&](State<Cost>&& state) {
+        pq.push_back(move(state));
+        push_heap(pq.begin(), pq.end(), greater<State<Cost>>());
+    };
+    pushState(State<Cost>(rootMatrix, {}, {}, startLowerBound));
     
     int iterations = 0;
     const int MAX_ITERATIONS_TO_SHOW = 3;
 
     while (!pq.empty()) {
-        State current = pq.top();
-        pq.pop();
+        pop_heap(pq.begin(), pq.end(), greater<State<Cost>>());
+        State<Cost> current = move(pq.back());
+        pq.pop_back();
         
         iterations++;
-        bool showDetails = (iterations <= MAX_ITERATIONS_TO_SHOW);
+        TELEMETRY_EXPAND(current.lowerBound, pq.size() + 1);
+        bool showDetails = DEBUG && (iterations <= MAX_ITERATIONS_TO_SHOW);
+
+        if (stats) {
+            stats->allocations = pool.allocations - allocationsBefore;
+            stats->nodesExpanded++;
+            stats->peakQueueSize = max(stats->peakQueueSize, pq.size() + 1);
+            if (stats->nodeLimit && stats->nodesExpanded > stats->nodeLimit) {
+                stats->limitReached = true;
+                return {};
+            }
+        }
 
         if (showDetails) {
             cout << "\nИтерация " << iterations << ":" << endl;
-            cout << "Текущая нижняя граница: " << current.lowerBound << endl;
+            cout << "Текущая нижняя граница: " << (double)current.lowerBound << endl;
             cout << "Включенные ребра: ";
             for (const auto& edge : current.included) {
                 cout << "(" << edge.first << "," << edge.second << ") ";
@@ -316,7 +674,7 @@ vector<pair<int, int>> littleAlgorithm(vector<vector<float>> costMatrix) {
         }
 
         // Если у нас есть n-1 ребро, нам нужно n-ое, чтобы завершить путь
-        if (current.included.size() == n - 1) {
+        if ((int)current.included.size() == n - 1) {
             // Построить путь из текущих ребер
             vector<int> next(n, -1);
             vector<int> inDegree(n, 0);
@@ -333,30 +691,31 @@ vector<pair<int, int>> littleAlgorithm(vector<vector<float>> costMatrix) {
                 if (next[i] == -1 && inDegree[i] == 1) end = i;
             }
             
-            // Если нашли начало и конец, добавляем последнее ребро
-            if (start != -1 && end != -1) {
+            // Если нашли начало и конец и замыкающее ребро есть во входной
+            // матрице, добавляем его. Приведенная матрица вершины не подходит:
+            // в ней ребро может быть исключено ветвлением, хотя тур допустим
+            if (start != -1 && end != -1 && costMatrix[end][start] != INF<Cost>) {
                 vector<pair<int, int>> result = current.included;
                 result.push_back({end, start});
+                TELEMETRY_INCUMBENT(result, costMatrix);
                 return result;
             }
         }
         
         // Выбираем ребро для ветвления
-        pair<int, int> edge = findBranchingEdge(current.costMatrix);
+        pair<int, int> edge = TELEMETRY_TIMED(branchingNs, findBranchingEdge(current.costMatrix));
         int i = edge.first, j = edge.second;
         
         if (i == -1 || j == -1) {
             if (showDetails) cout << "Не найдено ребро для ветвления, пропускаем" << endl;
+            TELEMETRY_COUNT(nodesPruned);
+            pool.release(current);
             continue;
         }
 
         if (showDetails) cout << "Выбрано ребро для ветвления: (" << i << "," << j << ")" << endl;
         
         // Включение ребра (i,j)
-        vector<vector<float>> includeMatrix = current.costMatrix;
-        vector<pair<int, int>> newIncluded = current.included;
-        newIncluded.push_back({i, j});
-        
         if (showDetails) cout << "Ветвь 1: Включаем ребро (" << i << "," << j << ")" << endl;
 
         // Проверяем, не создает ли новое ребро цикл (кроме полного гамильтонова цикла)
@@ -365,158 +724,1770 @@ vector<pair<int, int>> littleAlgorithm(vector<vector<float>> costMatrix) {
         
         if (hasCycle(current.included, {i, j}, cycle, n)) {
             // Если цикл меньше полного, пропускаем это ребро
-            if (cycle.size() < n) {
+            if ((int)cycle.size() < n) {
                 createsEarlyCycle = true;
             }
         }
         
+        if (createsEarlyCycle) TELEMETRY_COUNT(nodesPruned);
         if (!createsEarlyCycle) {
+            TELEMETRY_COUNT(includeBranches);
+            MatrixView<Cost> includeMatrix = pool.copyMatrix(current.costMatrix);
+            vector<pair<int, int>> newIncluded = pool.copyEdges(current.included);
+            pool.appendEdge(newIncluded, {i, j});
+
             // Обновляем матрицу, запрещая выходы из i и входы в j
             for (int k = 0; k < n; k++) {
-                includeMatrix[i][k] = INF;  // Запрещаем выходы из i
-                includeMatrix[k][j] = INF;  // Запрещаем входы в j
+                includeMatrix[i][k] = INF<Cost>;  // Запрещаем выходы из i
+                includeMatrix[k][j] = INF<Cost>;  // Запрещаем входы в j
             }
             
-            float includeReduction = reduceMatrix(includeMatrix);
-            float includeMST = calculateMSTBound(includeMatrix);
-            float includeLowerBound = current.lowerBound + includeReduction + includeMST;
+            Cost includeReduction = TELEMETRY_TIMED(reduceNs, reduceMatrix(includeMatrix));
+            Cost includeMST = TELEMETRY_TIMED(mstNs, calculateMSTBound(includeMatrix));
+            Cost includeLowerBound = addCost(addCost(current.lowerBound, includeReduction), includeMST);
 
-            if (showDetails) cout << "   Новая нижняя граница: " << includeLowerBound << endl;
+            if (showDetails) cout << "   Новая нижняя граница: " << (double)includeLowerBound << endl;
 
-            pq.push(State(includeMatrix, newIncluded, current.excluded, includeLowerBound));
+            pushState(State<Cost>(includeMatrix, move(newIncluded), pool.copyEdges(current.excluded), includeLowerBound));
         }
         
-        // Исключение ребра (i,j)
-        vector<vector<float>> excludeMatrix = current.costMatrix;
-        excludeMatrix[i][j] = INF;
+        // Исключение ребра (i,j): текущая вершина больше не нужна, поэтому
+        // ее буферы переходят к дочерней без копирования
+        MatrixView<Cost> excludeMatrix = current.costMatrix;
+        excludeMatrix[i][j] = INF<Cost>;
         
         if (showDetails) cout << "Ветвь 2: Исключаем ребро (" << i << "," << j << ")" << endl;
 
-        float excludeLowerBound = current.lowerBound + reduceMatrix(excludeMatrix) + calculateMSTBound(excludeMatrix);
+        TELEMETRY_COUNT(excludeBranches);
+        Cost excludeReduction = TELEMETRY_TIMED(reduceNs, reduceMatrix(excludeMatrix));
+        Cost excludeMST = TELEMETRY_TIMED(mstNs, calculateMSTBound(excludeMatrix));
+        Cost excludeLowerBound = addCost(addCost(current.lowerBound, excludeReduction), excludeMST);
 
-        if (showDetails) cout << "   Новая нижняя граница: " << excludeLowerBound << endl;
+        if (showDetails) cout << "   Новая нижняя граница: " << (double)excludeLowerBound << endl;
 
-        vector<pair<int, int>> newExcluded = current.excluded;
-        newExcluded.push_back({i, j});
-        
-        pq.push(State(excludeMatrix, current.included, newExcluded, excludeLowerBound));
+        pool.appendEdge(current.excluded, {i, j});
+        current.lowerBound = excludeLowerBound;
+        pushState(move(current));
     }
     
-    cout << "Решение не найдено\n" << endl;
+    if (stats) stats->allocations = pool.allocations - allocationsBefore;
+    if (DEBUG) cout << "Решение не найдено\n" << endl;
     return {};
 }
 
-// Функция для преобразования списка ребер в путь
-vector<int> edgesToPath(const vector<pair<int, int>>& edges, int n) {
-    if (edges.size() != n) return {};
-    
-    // Строим граф из ребер
-    vector<int> next(n, -1);
-    vector<int> inDegree(n, 0);
-    
-    for (const auto& edge : edges) {
-        next[edge.first] = edge.second;
-        inDegree[edge.second]++;
+// ---------------------------------------------------------------------------
+// Повторное решение после небольших изменений матрицы стоимостей.
+// Решатель хранит фронт дерева решений (листья с включенными/исключенными
+// ребрами и нижними границами) и найденный тур. После изменения стоимостей
+// пересчитываются только листья, в поддеревьях которых измененное ребро еще
+// может встретиться, после чего поиск продолжается с сохраненного фронта.
+// Граница здесь - только сумма редукций: в отличие от littleAlgorithm она
+// остается нижней границей поддерева, так что найденный тур оптимален.
+// ---------------------------------------------------------------------------
+
+// Изменение стоимости ребра
+template <typename Cost>
+struct CostUpdate {
+    int from, to;
+    Cost cost; // Новая стоимость (INF<Cost> - ребро удалено)
+};
+
+template <typename Cost>
+class IncrementalLittleSolver {
+public:
+    explicit IncrementalLittleSolver(vector<vector<Cost>> costMatrix)
+        : original(move(costMatrix)), n(original.size()), pool(n) {
+        for (int i = 0; i < n; i++) original[i][i] = INF<Cost>;
     }
-    
-    // Путь должен начинаться с 0
-    int city = 0;
-    vector<int> path;
-    path.push_back(city);
-    
-    for (int i = 1; i < n; i++) {
-        city = next[city];
-        if (city == -1) return {}; // Нет следующего города
-        path.push_back(city);
+
+    // Решение с нуля
+    vector<pair<int, int>> solve(SearchStats* stats = nullptr) {
+        for (auto& state : frontier) pool.release(state);
+        for (auto& state : infeasible) pool.release(state);
+        frontier.clear();
+        infeasible.clear();
+
+        State<Cost> root(pool.copyMatrix(original));
+        root.lowerBound = reduceMatrix(root.costMatrix);
+        pushState(move(root));
+        return resume(stats);
     }
-    
-    // Проверяем, можем ли вернуться в начало
-    if (next[city] == 0) {
-        return path;
+
+    // Изменение стоимостей и продолжение поиска с сохраненного фронта
+    vector<pair<int, int>> update(const vector<CostUpdate<Cost>>& updates, SearchStats* stats = nullptr) {
+        for (const auto& u : updates) {
+            if (u.from != u.to) original[u.from][u.to] = u.cost;
+        }
+
+        vector<State<Cost>> states;
+        states.swap(frontier);
+        for (auto& state : infeasible) states.push_back(move(state));
+        infeasible.clear();
+
+        for (auto& state : states) {
+            if (isAffected(state, updates)) {
+                rebuild(state);
+                if (stats) stats->nodesRevalidated++;
+            }
+            if (state.lowerBound == INF<Cost>) infeasible.push_back(move(state));
+            else frontier.push_back(move(state));
+        }
+        make_heap(frontier.begin(), frontier.end(), greater<State<Cost>>());
+
+        return resume(stats);
     }
-    
-    return {};
-}
 
-// Функция для вычисления общей стоимости пути
-float calculateTotalCost(const vector<int>& path, const vector<vector<float>>& originalCostMatrix) {
-    float totalCost = 0;
-    int n = path.size();
-    
-    if (n <= 1) return 0;
-    
-    // Суммируем стоимость переходов в пути
-    for (int i = 0; i < n - 1; i++) {
-        int from = path[i];
-        int to = path[i + 1];
-        totalCost += originalCostMatrix[from][to];
+    const vector<vector<Cost>>& costMatrix() const { return original; }
+
+private:
+    void pushState(State<Cost>&& state) {
+        if (state.lowerBound == INF<Cost>) {
+            infeasible.push_back(move(state));
+            return;
+        }
+        frontier.push_back(move(state));
+        push_heap(frontier.begin(), frontier.end(), greater<State<Cost>>());
     }
-    
-    // Добавляем стоимость возврата из последнего города в начальный
-    totalCost += originalCostMatrix[path[n - 1]][path[0]];
-    
-    return totalCost;
-}
 
-int main() {
+    // Может ли ребро (i, j) входить в туры поддерева: оно включено или еще
+    // не исключено явно и не закрыто включением другого ребра из i или в j
+    bool isAffected(const State<Cost>& state, const vector<CostUpdate<Cost>>& updates) const {
+        vector<char> rowClosed(n, 0), colClosed(n, 0);
+        for (const auto& edge : state.included) {
+            rowClosed[edge.first] = colClosed[edge.second] = 1;
+        }
+
+        for (const auto& u : updates) {
+            pair<int, int> edge = {u.from, u.to};
+            if (find(state.included.begin(), state.included.end(), edge) != state.included.end()) return true;
+            if (rowClosed[u.from] || colClosed[u.to]) continue;
+            if (find(state.excluded.begin(), state.excluded.end(), edge) == state.excluded.end()) return true;
+        }
+        return false;
+    }
+
+    // Пересчет матрицы и границы листа по его решениям и текущим стоимостям
+    void rebuild(State<Cost>& state) {
+        MatrixView<Cost> matrix = state.costMatrix;
+        for (int i = 0; i < n; i++) copy(original[i].begin(), original[i].end(), matrix[i]);
+
+        Cost includedCost = 0;
+        for (const auto& edge : state.included) {
+            includedCost = addCost(includedCost, original[edge.first][edge.second]);
+            for (int k = 0; k < n; k++) {
+                matrix[edge.first][k] = INF<Cost>;
+                matrix[k][edge.second] = INF<Cost>;
+            }
+        }
+        for (const auto& edge : state.excluded) matrix[edge.first][edge.second] = INF<Cost>;
+
+        state.lowerBound = addCost(includedCost, reduceMatrix(matrix));
+    }
+
+    vector<pair<int, int>> resume(SearchStats* stats) {
+        long long allocationsBefore = pool.allocations;
+        while (!frontier.empty()) {
+            pop_heap(frontier.begin(), frontier.end(), greater<State<Cost>>());
+            State<Cost> current = move(frontier.back());
+            frontier.pop_back();
+
+            if (stats) {
+                stats->allocations = pool.allocations - allocationsBefore;
+                stats->nodesExpanded++;
+                stats->peakQueueSize = max(stats->peakQueueSize, frontier.size() + 1);
+                if (stats->nodeLimit && stats->nodesExpanded > stats->nodeLimit) {
+                    stats->limitReached = true;
+                    frontier.push_back(move(current));
+                    push_heap(frontier.begin(), frontier.end(), greater<State<Cost>>());
+                    return {};
+                }
+            }
+
+            if ((int)current.included.size() == n - 1) {
+                vector<int> next(n, -1), inDegree(n, 0);
+                for (const auto& edge : current.included) {
+                    next[edge.first] = edge.second;
+                    inDegree[edge.second]++;
+                }
+                int start = -1, end = -1;
+                for (int i = 0; i < n; i++) {
+                    if (next[i] != -1 && inDegree[i] == 0) start = i;
+                    if (next[i] == -1 && inDegree[i] == 1) end = i;
+                }
+
+                // Замыкающее ребро проверяется по текущей матрице стоимостей: в
+                // приведенной матрице листа оно может быть исключено ветвлением.
+                // Такой тур граница листа не учитывает, поэтому он принимается,
+                // только если не дороже границы, иначе лист возвращается в
+                // очередь с границей, равной стоимости тура
+                if (start != -1 && end != -1 && original[end][start] != INF<Cost>) {
+                    vector<pair<int, int>> result = current.included;
+                    result.push_back({end, start});
+                    Cost tourCost = 0;
+                    for (const auto& e : result) tourCost = addCost(tourCost, original[e.first][e.second]);
+
+                    bool optimal = tourCost <= current.lowerBound;
+                    current.lowerBound = max(current.lowerBound, tourCost);
+                    // Лист с туром остается во фронте для следующих обновлений
+                    pushState(move(current));
+                    if (optimal) return result;
+                    continue;
+                }
+            }
+
+            pair<int, int> edge = findBranchingEdge(current.costMatrix);
+            int i = edge.first, j = edge.second;
+            if (i == -1 || j == -1) {
+                // Тур из этого листа достроить нельзя, но после обновления
+                // стоимостей он может снова стать допустимым
+                current.lowerBound = INF<Cost>;
+                infeasible.push_back(move(current));
+                continue;
+            }
+
+            vector<int> cycle;
+            bool createsEarlyCycle = hasCycle(current.included, {i, j}, cycle, n) && (int)cycle.size() < n;
+
+            if (!createsEarlyCycle) {
+                MatrixView<Cost> includeMatrix = pool.copyMatrix(current.costMatrix);
+                vector<pair<int, int>> newIncluded = pool.copyEdges(current.included);
+                pool.appendEdge(newIncluded, {i, j});
+                for (int k = 0; k < n; k++) {
+                    includeMatrix[i][k] = INF<Cost>;
+                    includeMatrix[k][j] = INF<Cost>;
+                }
+                Cost includeLowerBound = addCost(current.lowerBound, reduceMatrix(includeMatrix));
+                pushState(State<Cost>(includeMatrix, move(newIncluded), pool.copyEdges(current.excluded), includeLowerBound));
+            }
+
+            current.costMatrix[i][j] = INF<Cost>;
+            current.lowerBound = addCost(current.lowerBound, reduceMatrix(current.costMatrix));
+            pool.appendEdge(current.excluded, {i, j});
+            pushState(move(current));
+        }
+
+        if (stats) stats->allocations = pool.allocations - allocationsBefore;
+        return {};
+    }
+
+    vector<vector<Cost>> original;   // Текущая матрица стоимостей
     int n;
-    cin >> n;
-    
-    vector<vector<float>> costMatrix(n, vector<float>(n));
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            cin >> costMatrix[i][j];
-            if (costMatrix[i][j] == -1) {
-                costMatrix[i][j] = INF;
+    NodePool<Cost> pool;
+    vector<State<Cost>> frontier;    // Листья дерева решений (куча по нижней границе)
+    vector<State<Cost>> infeasible;  // Листья, из которых тур сейчас не достроить
+};
+
+// ---------------------------------------------------------------------------
+// Разреженное представление для входов, где большинство ребер отсутствует.
+// Структура графа (CSR по строкам и позиции тех же ребер по столбцам) общая
+// для всех вершин дерева решений, у вершины - только стоимости ребер.
+// Редукция, выбор ребра ветвления и граница MST работают за O(m) вместо
+// O(n^2) и повторяют порядок обхода плотных версий. Сверх того по строкам и
+// столбцам CSR отсекаются вершины дерева, где у города не осталось ни одного
+// разрешенного выхода или входа, а единственное оставшееся ребро города
+// выбирается для ветвления первым: ветвь без него сразу отсекается.
+//
+// Дерево решений поэтому меньше плотного, но граница (редукция плюс MST)
+// та же и может завышать стоимость, так что найденный тур иногда отличается
+// от тура littleAlgorithm в любую сторону. Граница от разреженности не
+// усиливается: экземпляры в сотни городов по-прежнему упираются в
+// ограничение на число вершин.
+// ---------------------------------------------------------------------------
+
+// Доля присутствующих ребер, ниже которой используется разреженный вариант
+const double SPARSE_DENSITY = 0.25;
+
+template <typename Cost>
+struct SparseGraph {
+    int n;
+    vector<int> rowPtr, colIdx;  // Ребра строки i: colIdx[rowPtr[i] .. rowPtr[i+1])
+    vector<int> colPtr, colPos;  // Ребра столбца j: позиции colPos[colPtr[j] .. colPtr[j+1]]
+    vector<Cost> costs;          // Исходные стоимости в порядке CSR
+
+    explicit SparseGraph(const vector<vector<Cost>>& matrix) : n(matrix.size()), rowPtr(n + 1, 0), colPtr(n + 1, 0) {
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                if (i == j || matrix[i][j] == INF<Cost>) continue;
+                colIdx.push_back(j);
+                costs.push_back(matrix[i][j]);
+                colPtr[j + 1]++;
             }
+            rowPtr[i + 1] = colIdx.size();
         }
+
+        for (int j = 0; j < n; j++) colPtr[j + 1] += colPtr[j];
+        colPos.resize(colIdx.size());
+        vector<int> fill(colPtr.begin(), colPtr.end() - 1);
+        for (int p = 0; p < (int)colIdx.size(); p++) colPos[fill[colIdx[p]]++] = p;
     }
-    
-    vector<vector<float>> originalCostMatrix = costMatrix;
-    
-    vector<int> absPath = nearestNeighborAlgorithm(originalCostMatrix);
-    vector<pair<int, int>> littleSolution = littleAlgorithm(costMatrix);
-    vector<int> littlePath = edgesToPath(littleSolution, n);
-    
-    float absCost = 0;
-    float littleCost = 0;
 
-    cout << "\n--- Результаты ---" << endl;
-    
-    cout << "Алгоритм ближайшего соседа (АБС):" << endl;
-    if (!absPath.empty()) {
-        cout << "Путь: ";
-        for (int i = 0; i < absPath.size(); i++) {
-            cout << absPath[i];
-            if (i < absPath.size() - 1) cout << " -> ";
+    // Позиция ребра (i, j) или -1
+    int find(int i, int j) const {
+        auto first = colIdx.begin() + rowPtr[i], last = colIdx.begin() + rowPtr[i + 1];
+        auto it = lower_bound(first, last, j);
+        return it != last && *it == j ? it - colIdx.begin() : -1;
+    }
+};
+
+template <typename Cost>
+bool isSparse(const vector<vector<Cost>>& costMatrix) {
+    size_t n = costMatrix.size(), edges = 0;
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            if (i != j && costMatrix[i][j] != INF<Cost>) edges++;
+    return n > 1 && edges < SPARSE_DENSITY * n * (n - 1);
+}
+
+template <typename Cost>
+struct SparseState {
+    vector<Cost> costs;              // Текущие стоимости ребер графа (INF - ребро запрещено)
+    vector<pair<int, int>> included;
+    vector<pair<int, int>> excluded;
+    Cost lowerBound;
+
+    bool operator>(const SparseState& other) const {
+        return lowerBound > other.lowerBound;
+    }
+};
+
+template <typename Cost>
+void printSparseMatrix(const SparseGraph<Cost>& graph, const vector<Cost>& costs, const string& title) {
+    cout << title << ":" << endl;
+    vector<Cost> row(graph.n);
+    for (int i = 0; i < graph.n; i++) {
+        fill(row.begin(), row.end(), INF<Cost>);
+        for (int p = graph.rowPtr[i]; p < graph.rowPtr[i + 1]; p++) row[graph.colIdx[p]] = costs[p];
+        for (Cost val : row) {
+            if (val == INF<Cost>)
+                cout << "INF ";
+            else
+                cout << fixed << setprecision(1) << (double)val << " ";
         }
-        cout << " -> " << absPath[0] << endl;
-        
-        absCost = calculateTotalCost(absPath, originalCostMatrix);
-        cout << "Общая стоимость: " << fixed << setprecision(1) << absCost << endl;
-    } 
-    
-    cout << "\nАлгоритм Литтла:" << endl;
-    if (!littlePath.empty()) {
-        cout << "Путь: ";
-        for (int i = 0; i < littlePath.size(); i++) {
-            cout << littlePath[i];
-            if (i < littlePath.size() - 1) cout << " -> ";
+        cout << endl;
+    }
+    cout << endl;
+}
+
+template <typename Cost>
+Cost reduceSparse(const SparseGraph<Cost>& graph, vector<Cost>& costs) {
+    Cost reduction = 0;
+
+    for (int i = 0; i < graph.n; i++) {
+        Cost minVal = INF<Cost>;
+        for (int p = graph.rowPtr[i]; p < graph.rowPtr[i + 1]; p++) minVal = min(minVal, costs[p]);
+        if (minVal == INF<Cost>) continue;
+        for (int p = graph.rowPtr[i]; p < graph.rowPtr[i + 1]; p++) {
+            if (costs[p] < INF<Cost>) costs[p] -= minVal;
         }
-        cout << " -> " << littlePath[0] << endl;
-        
-        littleCost = calculateTotalCost(littlePath, originalCostMatrix);
-        cout << "Общая стоимость: " << fixed << setprecision(1) << littleCost << endl;
+        reduction = addCost(reduction, minVal);
     }
-    
-    // Если оба алгоритма нашли решение, выводим сравнение
-    if (!absPath.empty() && !littlePath.empty()) {
-        float ratio = absCost / littleCost;
-        cout << "\nОтношение АБС/Литтл: " << fixed << setprecision(2) << ratio << endl;
+
+    for (int j = 0; j < graph.n; j++) {
+        Cost minVal = INF<Cost>;
+        for (int q = graph.colPtr[j]; q < graph.colPtr[j + 1]; q++) minVal = min(minVal, costs[graph.colPos[q]]);
+        if (minVal == INF<Cost>) continue;
+        for (int q = graph.colPtr[j]; q < graph.colPtr[j + 1]; q++) {
+            Cost& val = costs[graph.colPos[q]];
+            if (val < INF<Cost>) val -= minVal;
+        }
+        reduction = addCost(reduction, minVal);
     }
-    else if (absPath.empty() && littlePath.empty()) {
-        cout << "no path" << endl;
+
+    return reduction;
+}
+
+// Выбор нулевого ребра с наибольшим штрафом за исключение. Два наименьших
+// значения каждой строки и столбца считаются за один проход, так что минимум
+// без данного ребра находится за O(1)
+template <typename Cost>
+pair<int, int> findSparseBranchingEdge(const SparseGraph<Cost>& graph, const vector<Cost>& costs) {
+    int n = graph.n;
+    vector<Cost> rowMin1(n, INF<Cost>), rowMin2(n, INF<Cost>), colMin1(n, INF<Cost>), colMin2(n, INF<Cost>);
+    vector<int> rowArg(n, -1), colArg(n, -1);
+
+    for (int i = 0; i < n; i++) {
+        for (int p = graph.rowPtr[i]; p < graph.rowPtr[i + 1]; p++) {
+            Cost val = costs[p];
+            int j = graph.colIdx[p];
+            if (val < rowMin1[i]) {
+                rowMin2[i] = rowMin1[i];
+                rowMin1[i] = val;
+                rowArg[i] = p;
+            } else if (val < rowMin2[i]) {
+                rowMin2[i] = val;
+            }
+            if (val < colMin1[j]) {
+                colMin2[j] = colMin1[j];
+                colMin1[j] = val;
+                colArg[j] = p;
+            } else if (val < colMin2[j]) {
+                colMin2[j] = val;
+            }
+        }
     }
-    
-    return 0;
+
+    Cost maxCost = -1;
+    pair<int, int> edge = {-1, -1};
+    for (int i = 0; i < n; i++) {
+        for (int p = graph.rowPtr[i]; p < graph.rowPtr[i + 1]; p++) {
+            if (costs[p] != 0) continue;
+            int j = graph.colIdx[p];
+            Cost rowOther = p == rowArg[i] ? rowMin2[i] : rowMin1[i];
+            Cost colOther = p == colArg[j] ? colMin2[j] : colMin1[j];
+            // Последний выход из i или вход в j: без него тур не достроить
+            if (rowOther == INF<Cost> || colOther == INF<Cost>) return {i, j};
+
+            Cost cost = rowOther + colOther;
+            if (cost > maxCost) {
+                maxCost = cost;
+                edge = {i, j};
+            }
+        }
+    }
+
+    return edge;
+}
+
+// Та же оценка, что calculateMSTBound, но алгоритм Прима идет по куче и
+// смотрит только на присутствующие ребра
+template <typename Cost>
+Cost calculateSparseMSTBound(const SparseGraph<Cost>& graph, const vector<Cost>& costs) {
+    int n = graph.n;
+    if (n <= 2) return 0;
+
+    const int excludedVertex = 0;
+    const int startVertex = 1;
+    vector<bool> visited(n, false);
+    vector<Cost> minEdge(n, INF<Cost>);
+    visited[excludedVertex] = visited[startVertex] = true;
+
+    // При равных весах берется вершина с меньшим номером, как в плотной версии
+    priority_queue<pair<Cost, int>, vector<pair<Cost, int>>, greater<pair<Cost, int>>> heap;
+    auto relax = [&](int from) {
+        for (int p = graph.rowPtr[from]; p < graph.rowPtr[from + 1]; p++) {
+            int j = graph.colIdx[p];
+            if (!visited[j] && costs[p] < minEdge[j]) {
+                minEdge[j] = costs[p];
+                heap.push({costs[p], j});
+            }
+        }
+    };
+    relax(startVertex);
+
+    Cost mstWeight = 0;
+    for (int added = 0; added < n - 2 && !heap.empty();) {
+        auto [weight, v] = heap.top();
+        heap.pop();
+        if (visited[v] || weight != minEdge[v]) continue;
+
+        visited[v] = true;
+        mstWeight = addCost(mstWeight, weight);
+        added++;
+        relax(v);
+    }
+
+    Cost min1 = INF<Cost>, min2 = INF<Cost>;
+    for (int p = graph.rowPtr[excludedVertex]; p < graph.rowPtr[excludedVertex + 1]; p++) {
+        if (costs[p] < min1) {
+            min2 = min1;
+            min1 = costs[p];
+        } else if (costs[p] < min2) {
+            min2 = costs[p];
+        }
+    }
+
+    if (min1 < INF<Cost>) mstWeight = addCost(mstWeight, min1);
+    if (min2 < INF<Cost>) mstWeight = addCost(mstWeight, min2);
+
+    return mstWeight;
+}
+
+// У каждого города без включенного выхода (входа) должно остаться хотя бы одно
+// разрешенное исходящее (входящее) ребро, иначе вершину дерева можно отсечь.
+// Для последнего ребра тура не проверяется: замыкающее ребро ищется в графе
+template <typename Cost>
+bool sparseFeasible(const SparseGraph<Cost>& graph, const vector<Cost>& costs,
+                    const vector<pair<int, int>>& included) {
+    int n = graph.n;
+    if ((int)included.size() >= n - 1) return true;
+
+    vector<char> hasOut(n, 0), hasIn(n, 0);
+    for (const auto& edge : included) {
+        hasOut[edge.first] = 1;
+        hasIn[edge.second] = 1;
+    }
+    for (int i = 0; i < n; i++) {
+        if (hasOut[i]) continue;
+        int p = graph.rowPtr[i];
+        while (p < graph.rowPtr[i + 1] && costs[p] == INF<Cost>) p++;
+        if (p == graph.rowPtr[i + 1]) return false;
+    }
+    for (int j = 0; j < n; j++) {
+        if (hasIn[j]) continue;
+        int q = graph.colPtr[j];
+        while (q < graph.colPtr[j + 1] && costs[graph.colPos[q]] == INF<Cost>) q++;
+        if (q == graph.colPtr[j + 1]) return false;
+    }
+    return true;
+}
+
+// Алгоритм Литтла на разреженном представлении
+template <typename Cost>
+vector<pair<int, int>> littleSparseAlgorithm(const vector<vector<Cost>>& costMatrix, SearchStats* stats = nullptr,
+                                             NodePool<Cost>* sharedPool = nullptr) {
+    int n = costMatrix.size();
+    SparseGraph<Cost> graph(costMatrix);
+    TELEMETRY_RUN("little-sparse", n);
+
+    if (DEBUG) cout << "\n--- Выполнение алгоритма Литтла ---" << endl;
+
+    // Массивы стоимостей и списки ребер освободившихся вершин используются
+    // повторно; общий пул сохраняет их и между экземплярами
+    NodePool<Cost> ownPool(0);
+    NodePool<Cost>& pool = sharedPool ? *sharedPool : ownPool;
+    pool.reset(n);
+    long long allocationsBefore = pool.allocations;
+    auto releaseState = [&](SparseState<Cost>& state) {
+        pool.releaseCosts(state.costs);
+        pool.releaseEdges(state.included);
+        pool.releaseEdges(state.excluded);
+    };
+    SparseState<Cost> root{pool.copyCosts(graph.costs), {}, {}, 0};
+
+    if (DEBUG) cout << "Начальная матрица стоимости:" << endl;
+    if (DEBUG) printSparseMatrix(graph, root.costs, "Исходная матрица");
+
+    Cost reduction = TELEMETRY_TIMED(reduceNs, reduceSparse(graph, root.costs));
+    if (DEBUG) cout << "Значение редукции матрицы: " << (double)reduction << endl;
+
+    if (DEBUG) printSparseMatrix(graph, root.costs, "Матрица после редукции");
+
+    root.lowerBound = addCost(reduction, TELEMETRY_TIMED(mstNs, calculateSparseMSTBound(graph, root.costs)));
+    if (DEBUG) cout << "Начальная нижняя граница: " << (double)root.lowerBound << endl;
+
+    vector<SparseState<Cost>> pq;
+    auto pushState = [&](SparseState<Cost>&& state) {
+        pq.push_back(move(state));
+        push_heap(pq.begin(), pq.end(), greater<SparseState<Cost>>());
+    };
+    pushState(move(root));
+
+    int iterations = 0;
+    const int MAX_ITERATIONS_TO_SHOW = 3;
+
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<SparseState<Cost>>());
+        SparseState<Cost> current = move(pq.back());
+        pq.pop_back();
+
+        iterations++;
+        TELEMETRY_EXPAND(current.lowerBound, pq.size() + 1);
+        bool showDetails = DEBUG && (iterations <= MAX_ITERATIONS_TO_SHOW);
+
+        if (stats) {
+            stats->allocations = pool.allocations - allocationsBefore;
+            stats->nodesExpanded++;
+            stats->peakQueueSize = max(stats->peakQueueSize, pq.size() + 1);
+            if (stats->nodeLimit && stats->nodesExpanded > stats->nodeLimit) {
+                stats->limitReached = true;
+                return {};
+            }
+        }
+
+        if (showDetails) {
+            cout << "\nИтерация " << iterations << ":" << endl;
+            cout << "Текущая нижняя граница: " << (double)current.lowerBound << endl;
+            cout << "Включенные ребра: ";
+            for (const auto& edge : current.included) {
+                cout << "(" << edge.first << "," << edge.second << ") ";
+            }
+            cout << endl;
+        }
+
+        if ((int)current.included.size() == n - 1) {
+            vector<int> next(n, -1), inDegree(n, 0);
+            for (const auto& edge : current.included) {
+                next[edge.first] = edge.second;
+                inDegree[edge.second]++;
+            }
+
+            int start = -1, end = -1;
+            for (int i = 0; i < n; i++) {
+                if (next[i] != -1 && inDegree[i] == 0) start = i;
+                if (next[i] == -1 && inDegree[i] == 1) end = i;
+            }
+
+            // Замыкающее ребро ищется в исходном графе, а не в стоимостях
+            // вершины, где оно может быть исключено ветвлением
+            if (start != -1 && end != -1 && graph.find(end, start) != -1) {
+                vector<pair<int, int>> result = current.included;
+                result.push_back({end, start});
+                TELEMETRY_INCUMBENT(result, costMatrix);
+                return result;
+            }
+        }
+
+        pair<int, int> edge = TELEMETRY_TIMED(branchingNs, findSparseBranchingEdge(graph, current.costs));
+        int i = edge.first, j = edge.second;
+
+        if (i == -1 || j == -1) {
+            if (showDetails) cout << "Не найдено ребро для ветвления, пропускаем" << endl;
+            TELEMETRY_COUNT(nodesPruned);
+            releaseState(current);
+            continue;
+        }
+
+        if (showDetails) cout << "Выбрано ребро для ветвления: (" << i << "," << j << ")" << endl;
+        if (showDetails) cout << "Ветвь 1: Включаем ребро (" << i << "," << j << ")" << endl;
+
+        vector<int> cycle;
+        bool createsEarlyCycle = hasCycle(current.included, {i, j}, cycle, n) && (int)cycle.size() < n;
+
+        if (createsEarlyCycle) TELEMETRY_COUNT(nodesPruned);
+        if (!createsEarlyCycle) {
+            TELEMETRY_COUNT(includeBranches);
+            SparseState<Cost> include{pool.copyCosts(current.costs), pool.copyEdges(current.included),
+                                      pool.copyEdges(current.excluded), 0};
+            pool.appendEdge(include.included, {i, j});
+
+            // Запрещаем выходы из i и входы в j
+            for (int p = graph.rowPtr[i]; p < graph.rowPtr[i + 1]; p++) include.costs[p] = INF<Cost>;
+            for (int q = graph.colPtr[j]; q < graph.colPtr[j + 1]; q++) include.costs[graph.colPos[q]] = INF<Cost>;
+
+            if (sparseFeasible(graph, include.costs, include.included)) {
+                Cost includeReduction = TELEMETRY_TIMED(reduceNs, reduceSparse(graph, include.costs));
+                Cost includeMST = TELEMETRY_TIMED(mstNs, calculateSparseMSTBound(graph, include.costs));
+                include.lowerBound = addCost(addCost(current.lowerBound, includeReduction), includeMST);
+
+                if (showDetails) cout << "   Новая нижняя граница: " << (double)include.lowerBound << endl;
+
+                pushState(move(include));
+            } else {
+                if (showDetails) cout << "   У города не осталось выхода или входа, ветвь отсечена" << endl;
+                TELEMETRY_COUNT(nodesPruned);
+                releaseState(include);
+            }
+        }
+
+        // Исключение ребра (i,j) переиспользует массив текущей вершины
+        current.costs[graph.find(i, j)] = INF<Cost>;
+
+        if (showDetails) cout << "Ветвь 2: Исключаем ребро (" << i << "," << j << ")" << endl;
+
+        TELEMETRY_COUNT(excludeBranches);
+        if (!sparseFeasible(graph, current.costs, current.included)) {
+            if (showDetails) cout << "   У города не осталось выхода или входа, ветвь отсечена" << endl;
+            TELEMETRY_COUNT(nodesPruned);
+            releaseState(current);
+            continue;
+        }
+        Cost excludeReduction = TELEMETRY_TIMED(reduceNs, reduceSparse(graph, current.costs));
+        Cost excludeMST = TELEMETRY_TIMED(mstNs, calculateSparseMSTBound(graph, current.costs));
+        current.lowerBound = addCost(addCost(current.lowerBound, excludeReduction), excludeMST);
+
+        if (showDetails) cout << "   Новая нижняя граница: " << (double)current.lowerBound << endl;
+
+        pool.appendEdge(current.excluded, {i, j});
+        pushState(move(current));
+    }
+
+    if (stats) stats->allocations = pool.allocations - allocationsBefore;
+    if (DEBUG) cout << "Решение не найдено\n" << endl;
+    return {};
+}
+
+// Функция для преобразования списка ребер в путь
+vector<int> edgesToPath(const vector<pair<int, int>>& edges, int n) {
+    if ((int)edges.size() != n) return {};
+    
+    // Строим граф из ребер
+    vector<int> next(n, -1);
+    vector<int> inDegree(n, 0);
+    
+    for (const auto& edge : edges) {
+        next[edge.first] = edge.second;
+        inDegree[edge.second]++;
+    }
+    
+    // Путь должен начинаться с 0
+    int city = 0;
+    vector<int> path;
+    path.push_back(city);
+    
+    for (int i = 1; i < n; i++) {
+        city = next[city];
+        if (city == -1) return {}; // Нет следующего города
+        path.push_back(city);
+    }
+    
+    // Проверяем, можем ли вернуться в начало
+    if (next[city] == 0) {
+        return path;
+    }
+    
+    return {};
+}
+
+// Функция для вычисления общей стоимости пути
+template <typename Cost>
+Cost calculateTotalCost(const vector<int>& path, const vector<vector<Cost>>& originalCostMatrix) {
+    Cost totalCost = 0;
+    int n = path.size();
+    
+    if (n <= 1) return 0;
+    
+    // Суммируем стоимость переходов в пути
+    for (int i = 0; i < n - 1; i++) {
+        int from = path[i];
+        int to = path[i + 1];
+        totalCost = addCost(totalCost, originalCostMatrix[from][to]);
+    }
+    
+    // Добавляем стоимость возврата из последнего города в начальный
+    totalCost = addCost(totalCost, originalCostMatrix[path[n - 1]][path[0]]);
+    
+    return totalCost;
+}
+
+// ---------------------------------------------------------------------------
+// Эвристика локального поиска для больших экземпляров (десятки тысяч городов),
+// где алгоритм Литтла неприменим, а АБС за O(n^2) дает слабые туры.
+// Ходы 2-opt и Or-opt перебираются только по спискам k ближайших кандидатов,
+// а "don't-look bits" (очередь активных вершин) отсекают уже улучшенные места.
+// ---------------------------------------------------------------------------
+
+const int DEFAULT_CANDIDATES = 8;
+
+// Списки кандидатов по матрице стоимостей: k ближайших соседей каждой вершины.
+// Для несимметричной матрицы объединяются k лучших исходящих и k лучших
+// входящих соседей, чтобы кандидаты годились для ходов в обе стороны
+template <typename Cost>
+vector<vector<int>> buildCandidateLists(const vector<vector<Cost>>& costMatrix, int k) {
+    int n = costMatrix.size();
+    vector<vector<int>> candidates(n);
+    vector<int> order;
+
+    auto nearest = [&](int i, bool outgoing, vector<int>& result) {
+        auto cost = [&](int j) { return outgoing ? costMatrix[i][j] : costMatrix[j][i]; };
+
+        order.clear();
+        for (int j = 0; j < n; j++) {
+            if (j != i && cost(j) < INF<Cost>) order.push_back(j);
+        }
+
+        int count = min<int>(k, order.size());
+        auto byCost = [&](int a, int b) { return cost(a) < cost(b); };
+        nth_element(order.begin(), order.begin() + count, order.end(), byCost);
+        sort(order.begin(), order.begin() + count, byCost);
+        for (int t = 0; t < count; t++) {
+            if (find(result.begin(), result.end(), order[t]) == result.end()) result.push_back(order[t]);
+        }
+    };
+
+    for (int i = 0; i < n; i++) {
+        nearest(i, true, candidates[i]);
+        nearest(i, false, candidates[i]);
+    }
+
+    return candidates;
+}
+
+// Списки кандидатов по координатам городов с помощью равномерной сетки:
+// для каждой точки просматриваются кольца ячеек, пока k-й сосед не окажется
+// ближе, чем любая точка из следующего кольца
+vector<vector<int>> buildCandidateLists(const vector<pair<float, float>>& points, int k) {
+    int n = points.size();
+    vector<vector<int>> candidates(n);
+    if (n <= 1) return candidates;
+
+    float minX = points[0].first, maxX = minX;
+    float minY = points[0].second, maxY = minY;
+    for (const auto& p : points) {
+        minX = min(minX, p.first);  maxX = max(maxX, p.first);
+        minY = min(minY, p.second); maxY = max(maxY, p.second);
+    }
+
+    // В среднем около двух точек на ячейку
+    int side = max(1, (int)sqrt(n / 2.0));
+    float cellW = max((maxX - minX) / side, 1e-9f);
+    float cellH = max((maxY - minY) / side, 1e-9f);
+    auto cellOf = [&](float v, float lo, float w) { return min(side - 1, (int)((v - lo) / w)); };
+
+    vector<int> cellStart(side * side + 1, 0), cellPoints(n);
+    for (const auto& p : points) {
+        cellStart[cellOf(p.second, minY, cellH) * side + cellOf(p.first, minX, cellW) + 1]++;
+    }
+    for (int c = 0; c < side * side; c++) cellStart[c + 1] += cellStart[c];
+    vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < n; i++) {
+        int c = cellOf(points[i].second, minY, cellH) * side + cellOf(points[i].first, minX, cellW);
+        cellPoints[fill[c]++] = i;
+    }
+
+    int count = min(k, n - 1);
+    vector<pair<float, int>> heap; // max-куча из лучших найденных (квадрат расстояния, вершина)
+
+    for (int i = 0; i < n; i++) {
+        int cx = cellOf(points[i].first, minX, cellW);
+        int cy = cellOf(points[i].second, minY, cellH);
+        heap.clear();
+
+        for (int r = 0; r <= side; r++) {
+            for (int y = cy - r; y <= cy + r; y++) {
+                if (y < 0 || y >= side) continue;
+                bool edgeRow = (y == cy - r || y == cy + r);
+                for (int x = cx - r; x <= cx + r; x += (edgeRow ? 1 : 2 * r)) {
+                    if (x >= 0 && x < side) {
+                        int c = y * side + x;
+                        for (int t = cellStart[c]; t < cellStart[c + 1]; t++) {
+                            int j = cellPoints[t];
+                            if (j == i) continue;
+                            float dx = points[i].first - points[j].first;
+                            float dy = points[i].second - points[j].second;
+                            float d2 = dx * dx + dy * dy;
+                            if ((int)heap.size() < count) {
+                                heap.push_back({d2, j});
+                                push_heap(heap.begin(), heap.end());
+                            } else if (d2 < heap.front().first) {
+                                pop_heap(heap.begin(), heap.end());
+                                heap.back() = {d2, j};
+                                push_heap(heap.begin(), heap.end());
+                            }
+                        }
+                    }
+                    if (r == 0) break;
+                }
+            }
+
+            // Любая точка вне просмотренных колец дальше, чем r ячеек
+            float reach = r * min(cellW, cellH);
+            if ((int)heap.size() == count && heap.front().first <= reach * reach) break;
+        }
+
+        sort_heap(heap.begin(), heap.end());
+        for (const auto& entry : heap) candidates[i].push_back(entry.second);
+    }
+
+    return candidates;
+}
+
+// Начальный тур для локального поиска: ближайший сосед по спискам кандидатов,
+// с полным просмотром непосещенных вершин, только если все кандидаты заняты
+template <typename Dist>
+vector<int> candidateNearestNeighbor(int n, const vector<vector<int>>& candidates, Dist dist) {
+    using Cost = decltype(dist(0, 0));
+    vector<int> tour;
+    tour.reserve(n);
+
+    vector<int> unvisited(n), where(n);
+    for (int i = 0; i < n; i++) unvisited[i] = where[i] = i;
+    auto visit = [&](int v) {
+        int last = unvisited.back();
+        unvisited[where[v]] = last;
+        where[last] = where[v];
+        unvisited.pop_back();
+        where[v] = -1;
+        tour.push_back(v);
+    };
+
+    visit(0);
+    while (!unvisited.empty()) {
+        int current = tour.back();
+        int next = -1;
+
+        // Для несимметричных стоимостей порядок кандидатов не совпадает
+        // с порядком по dist(current, c), поэтому просматриваем всех
+        Cost best = INF<Cost>;
+        for (int c : candidates[current]) {
+            if (where[c] != -1 && dist(current, c) < best) { best = dist(current, c); next = c; }
+        }
+
+        if (next == -1) {
+            next = unvisited[0];
+            for (int c : unvisited) {
+                Cost d = dist(current, c);
+                if (d < best) { best = d; next = c; }
+            }
+        }
+
+        visit(next);
+    }
+
+    return tour;
+}
+
+// Локальный поиск 2-opt (только для симметричных стоимостей) и Or-opt
+// (перенос отрезка из 1-3 вершин, с разворотом для симметричных стоимостей)
+template <typename Dist>
+void localSearch(vector<int>& tour, const vector<vector<int>>& candidates, Dist dist, bool symmetric) {
+    using Cost = decltype(dist(0, 0));
+    int n = tour.size();
+    if (n < 5) return;
+
+    vector<int> pos(n);
+    for (int i = 0; i < n; i++) pos[tour[i]] = i;
+
+    auto succ = [&](int v) { return tour[pos[v] + 1 == n ? 0 : pos[v] + 1]; };
+    auto pred = [&](int v) { return tour[pos[v] == 0 ? n - 1 : pos[v] - 1]; };
+    // Для вещественных стоимостей улучшение должно превышать погрешность
+    // округления, иначе ходы могут зацикливаться
+    auto improves = [](Cost added, Cost removed) {
+        if constexpr (is_floating_point_v<Cost>) return added < removed - Cost(1e-6) * max(Cost(1), removed);
+        else return added < removed;
+    };
+
+    // Разворот участка тура между позициями i и j (по циклу); если участок
+    // длиннее половины тура, разворачивается дополнение - для симметричных
+    // стоимостей это тот же тур
+    auto reverseSegment = [&](int i, int j) {
+        int len = ((j - i) % n + n) % n + 1;
+        if (2 * len > n) {
+            int ni = (j + 1) % n;
+            j = (i - 1 + n) % n;
+            i = ni;
+            len = n - len;
+        }
+        for (int t = 0; t < len / 2; t++) {
+            int a = (i + t) % n, b = ((j - t) % n + n) % n;
+            swap(tour[a], tour[b]);
+            pos[tour[a]] = a;
+            pos[tour[b]] = b;
+        }
+    };
+
+    // Перенос отрезка из len вершин, начинающегося с s, сразу за вершину c.
+    // Сдвигается более короткая из двух дуг между отрезком и точкой вставки
+    vector<int> segment;
+    auto moveSegment = [&](int s, int len, int c, bool reversed) {
+        int i = pos[s], q = pos[c];
+        segment.clear();
+        for (int t = 0; t < len; t++) segment.push_back(tour[(i + t) % n]);
+        if (reversed) std::reverse(segment.begin(), segment.end());
+
+        int forward = ((q - (i + len - 1)) % n + n) % n;
+        int backward = ((i - 1 - q) % n + n) % n;
+        int start;
+        if (forward <= backward) {
+            for (int t = 0; t < forward; t++) {
+                int to = (i + t) % n;
+                tour[to] = tour[(i + len + t) % n];
+                pos[tour[to]] = to;
+            }
+            start = i + forward;
+        } else {
+            for (int t = backward - 1; t >= 0; t--) {
+                int to = (q + 1 + t + len) % n;
+                tour[to] = tour[(q + 1 + t) % n];
+                pos[tour[to]] = to;
+            }
+            start = q + 1;
+        }
+        for (int t = 0; t < len; t++) {
+            int to = (start + t) % n;
+            tour[to] = segment[t];
+            pos[tour[to]] = to;
+        }
+    };
+
+    // Очередь активных вершин вместо явных don't-look bits
+    vector<int> active(tour.begin(), tour.end());
+    vector<char> queued(n, 1);
+    size_t head = 0;
+    auto activate = [&](int v) {
+        if (!queued[v]) { queued[v] = 1; active.push_back(v); }
+    };
+
+    auto tryTwoOpt = [&](int a) {
+        for (int dir = 0; dir < 2; dir++) {
+            int b = dir == 0 ? succ(a) : pred(a);
+            Cost dab = dist(a, b);
+            for (int c : candidates[a]) {
+                Cost dac = dist(a, c);
+                if (dac >= dab) break;
+                int d = dir == 0 ? succ(c) : pred(c);
+                if (c == b || d == a) continue;
+                if (!improves(addCost(dac, dist(b, d)), addCost(dab, dist(c, d)))) continue;
+
+                if (dir == 0) reverseSegment(pos[b], pos[c]);
+                else reverseSegment(pos[a], pos[d]);
+                activate(a); activate(b); activate(c); activate(d);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto tryOrOpt = [&](int s) {
+        int e = s;
+        for (int len = 1; len <= 3 && len < n - 3; len++) {
+            if (len > 1) e = succ(e);
+            int p = pred(s), nx = succ(e);
+            Cost removed = addCost(dist(p, s), dist(e, nx));
+            Cost closing = dist(p, nx);
+            if (closing >= INF<Cost> || !improves(closing, removed)) continue;
+
+            auto inSegment = [&](int v) { return ((pos[v] - pos[s]) % n + n) % n < len; };
+
+            // Вставка между c и succ(c) или между pred(c) и c, отрезок примыкает
+            // к кандидату своим началом (side = 0) или концом (side = 1)
+            for (int side = 0; side < 2; side++) {
+                int end = side == 0 ? s : e;
+                for (int c : candidates[end]) {
+                    if (inSegment(c)) continue;
+                    for (int orient = 0; orient < (symmetric ? 2 : 1); orient++) {
+                        int left, right;
+                        if (side == 0) {
+                            // s примыкает к c
+                            if (orient == 0) { left = c; right = succ(c); }  // c -> s ... e -> right
+                            else { left = pred(c); right = c; }              // left -> e ... s -> c
+                        } else {
+                            // e примыкает к c
+                            if (orient == 0) { left = pred(c); right = c; }  // left -> s ... e -> c
+                            else { left = c; right = succ(c); }              // c -> e ... s -> right
+                        }
+                        if (inSegment(left) || inSegment(right)) continue;
+
+                        bool reversed = orient == 1;
+                        Cost added = reversed ? addCost(dist(left, e), dist(s, right))
+                                              : addCost(dist(left, s), dist(e, right));
+                        if (!improves(addCost(added, closing), addCost(removed, dist(left, right)))) continue;
+
+                        moveSegment(s, len, left, reversed);
+                        activate(p); activate(nx); activate(s); activate(e);
+                        activate(left); activate(right);
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    };
+
+    while (head < active.size()) {
+        int v = active[head++];
+        queued[v] = 0;
+
+        bool improved = (symmetric && tryTwoOpt(v)) || tryOrOpt(v);
+        if (improved) activate(v);
+
+        // Периодически уплотняем очередь, чтобы она не росла без предела
+        if (head > (size_t)n && head * 2 > active.size()) {
+            active.erase(active.begin(), active.begin() + head);
+            head = 0;
+        }
+    }
+}
+
+template <typename Cost>
+bool isSymmetric(const vector<vector<Cost>>& costMatrix) {
+    int n = costMatrix.size();
+    for (int i = 0; i < n; i++)
+        for (int j = i + 1; j < n; j++)
+            if (costMatrix[i][j] != costMatrix[j][i]) return false;
+    return true;
+}
+
+// Локальный поиск по матрице стоимостей (тот же интерфейс, что и у АБС)
+template <typename Cost>
+vector<int> localSearchAlgorithm(const vector<vector<Cost>>& costMatrix, int k = DEFAULT_CANDIDATES) {
+    int n = costMatrix.size();
+    if (n == 0) return {};
+
+    auto dist = [&](int a, int b) { return costMatrix[a][b]; };
+    bool symmetric = isSymmetric(costMatrix);
+    vector<vector<int>> candidates = buildCandidateLists(costMatrix, k);
+    // Для несимметричной матрицы ближайший исходящий сосед может не попасть
+    // в объединенный список, поэтому начальный тур строится полным перебором
+    vector<int> tour = candidateNearestNeighbor(n, symmetric ? candidates : vector<vector<int>>(n), dist);
+    localSearch(tour, candidates, dist, symmetric);
+
+    // Тур с запрещенным ребром не является решением
+    for (int i = 0; i < n; i++) {
+        if (costMatrix[tour[i]][tour[(i + 1) % n]] == INF<Cost>) return {};
+    }
+
+    // Путь начинается с вершины 0, как у остальных алгоритмов
+    rotate(tour.begin(), find(tour.begin(), tour.end(), 0), tour.end());
+    return tour;
+}
+
+// Локальный поиск по координатам городов (евклидовы расстояния вычисляются
+// на лету, матрица n x n не строится)
+vector<int> localSearchAlgorithm(const vector<pair<float, float>>& points, int k = DEFAULT_CANDIDATES) {
+    int n = points.size();
+    if (n == 0) return {};
+
+    auto dist = [&](int a, int b) {
+        return hypot(points[a].first - points[b].first, points[a].second - points[b].second);
+    };
+    vector<vector<int>> candidates = buildCandidateLists(points, k);
+    vector<int> tour = candidateNearestNeighbor(n, candidates, dist);
+    localSearch(tour, candidates, dist, true);
+
+    rotate(tour.begin(), find(tour.begin(), tour.end(), 0), tour.end());
+    return tour;
+}
+
+// ---------------------------------------------------------------------------
+// Алгоритм Литтла для симметричных матриц. Стоимости неориентированных ребер
+// хранятся в упакованной треугольной матрице (вдвое меньше памяти на вершину
+// дерева решений), ветвление идет по неориентированным ребрам, поэтому
+// зеркальные туры не перебираются дважды. Нижняя граница - максимум из
+// границы по двум ближайшим соседям и 1-дерева с учетом включенных ребер.
+// ---------------------------------------------------------------------------
+
+// Упакованная треугольная матрица: хранятся только элементы с i > j
+template <typename Cost>
+struct TriangularMatrix {
+    int n = 0;
+    vector<Cost> data;
+
+    TriangularMatrix() = default;
+
+    TriangularMatrix(const vector<vector<Cost>>& matrix, NodePool<Cost>& pool)
+        : n(matrix.size()), data(pool.acquireCosts(n > 1 ? (size_t)n * (n - 1) / 2 : 0)) {
+        for (int i = 1; i < n; i++)
+            for (int j = 0; j < i; j++)
+                at(i, j) = matrix[i][j];
+    }
+
+    static size_t index(int i, int j) {
+        if (i < j) swap(i, j);
+        return (size_t)i * (i - 1) / 2 + j;
+    }
+
+    Cost& at(int i, int j) { return data[index(i, j)]; }
+    Cost at(int i, int j) const { return data[index(i, j)]; }
+};
+
+template <typename Cost>
+struct SymmetricState {
+    TriangularMatrix<Cost> available;       // Стоимости нерешенных ребер (INF<Cost> - ребро исключено или уже включено)
+    vector<pair<int, int>> included;  // Список включенных ребер
+    vector<int> degree;               // Число включенных ребер у каждой вершины
+    vector<int> pathEnd;              // Для конца цепочки включенных ребер - ее другой конец
+    Cost includedCost = 0;           // Суммарная стоимость включенных ребер
+    Cost lowerBound = 0;             // Нижняя граница стоимости решения
+    bool complete = false;            // Включены все n ребер тура
+
+    SymmetricState() = default;
+
+    SymmetricState(const vector<vector<Cost>>& matrix, NodePool<Cost>& pool)
+        : available(matrix, pool), degree(pool.acquireIndices(matrix.size())),
+          pathEnd(pool.acquireIndices(matrix.size())) {
+        for (int v = 0; v < (int)pathEnd.size(); v++) pathEnd[v] = v;
+    }
+
+    // Копия вершины в буферах пула
+    SymmetricState copy(NodePool<Cost>& pool) const {
+        SymmetricState state;
+        state.available.n = available.n;
+        state.available.data = pool.copyCosts(available.data);
+        state.included = pool.copyEdges(included);
+        state.degree = pool.copyIndices(degree);
+        state.pathEnd = pool.copyIndices(pathEnd);
+        state.includedCost = includedCost;
+        state.lowerBound = lowerBound;
+        state.complete = complete;
+        return state;
+    }
+
+    void release(NodePool<Cost>& pool) {
+        pool.releaseCosts(available.data);
+        pool.releaseEdges(included);
+        pool.releaseIndices(degree);
+        pool.releaseIndices(pathEnd);
+    }
+
+    bool operator>(const SymmetricState& other) const {
+        return lowerBound > other.lowerBound;
+    }
+};
+
+// Нижняя граница для симметричного случая; INF<Cost>, если продолжить тур нельзя
+template <typename Cost>
+Cost symmetricLowerBound(const SymmetricState<Cost>& state) {
+    const TriangularMatrix<Cost>& a = state.available;
+    int n = a.n;
+
+    // Граница по двум ближайшим соседям: каждое ребро тура учтено у обоих концов
+    Cost halfSum = 0;
+    for (int v = 0; v < n; v++) {
+        int need = 2 - state.degree[v];
+        if (need == 0) continue;
+
+        Cost min1 = INF<Cost>, min2 = INF<Cost>;
+        for (int u = 0; u < n; u++) {
+            if (u == v) continue;
+            Cost c = a.at(v, u);
+            if (c < min1) { min2 = min1; min1 = c; }
+            else if (c < min2) min2 = c;
+        }
+
+        if (min1 == INF<Cost> || (need == 2 && min2 == INF<Cost>)) return INF<Cost>;
+        halfSum += (need == 2) ? min1 + min2 : min1;
+    }
+    // Для целых стоимостей половину можно округлить вверх: стоимость тура целая
+    if constexpr (is_integral_v<Cost>) halfSum = (halfSum + 1) / 2;
+    else halfSum /= 2;
+    Cost degreeBound = addCost(state.includedCost, halfSum);
+
+    // 1-дерево: остовное дерево на вершинах 1..n-1, содержащее включенные ребра,
+    // плюс два ребра вершины 0
+    vector<int> parent(n);
+    for (int v = 0; v < n; v++) parent[v] = v;
+    auto findRoot = [&](int v) {
+        while (parent[v] != v) v = parent[v] = parent[parent[v]];
+        return v;
+    };
+
+    Cost treeCost = 0;
+    int components = n - 1;
+    int zeroDegree = 0;
+    // Стоимость включенных ребер уже учтена в includedCost, здесь они
+    // только объединяют компоненты
+    for (const auto& edge : state.included) {
+        if (edge.first == 0 || edge.second == 0) {
+            zeroDegree++;
+            continue;
+        }
+        int ru = findRoot(edge.first), rv = findRoot(edge.second);
+        if (ru != rv) { parent[ru] = rv; components--; }
+    }
+
+    vector<pair<Cost, pair<int, int>>> edges;
+    for (int i = 2; i < n; i++)
+        for (int j = 1; j < i; j++)
+            if (a.at(i, j) < INF<Cost>) edges.push_back({a.at(i, j), {i, j}});
+    sort(edges.begin(), edges.end());
+
+    for (const auto& edge : edges) {
+        if (components == 1) break;
+        int ru = findRoot(edge.second.first), rv = findRoot(edge.second.second);
+        if (ru != rv) {
+            parent[ru] = rv;
+            components--;
+            treeCost += edge.first;
+        }
+    }
+    if (components > 1) return INF<Cost>;
+
+    Cost min1 = INF<Cost>, min2 = INF<Cost>;
+    for (int u = 1; u < n; u++) {
+        Cost c = a.at(0, u);
+        if (c < min1) { min2 = min1; min1 = c; }
+        else if (c < min2) min2 = c;
+    }
+    int need = 2 - zeroDegree;
+    if ((need >= 1 && min1 == INF<Cost>) || (need == 2 && min2 == INF<Cost>)) return INF<Cost>;
+    if (need >= 1) treeCost = addCost(treeCost, min1);
+    if (need == 2) treeCost = addCost(treeCost, min2);
+
+    // Все включенные ребра входят в 1-дерево
+    Cost oneTreeBound = addCost(treeCost, state.includedCost);
+
+    return max(degreeBound, oneTreeBound);
+}
+
+// Ребро для ветвления: у незаполненной вершины с наименьшим числом
+// оставшихся ребер (при равенстве - с большей степенью) берется самое дешевое
+template <typename Cost>
+pair<int, int> findSymmetricBranchingEdge(const SymmetricState<Cost>& state) {
+    const TriangularMatrix<Cost>& a = state.available;
+    int n = a.n;
+    int bestVertex = -1, bestOptions = n + 1;
+
+    for (int v = 0; v < n; v++) {
+        if (state.degree[v] == 2) continue;
+        int options = 0;
+        for (int u = 0; u < n; u++)
+            if (u != v && a.at(v, u) < INF<Cost>) options++;
+        if (options < bestOptions ||
+            (options == bestOptions && state.degree[v] > state.degree[bestVertex])) {
+            bestOptions = options;
+            bestVertex = v;
+        }
+    }
+    if (bestVertex == -1) return {-1, -1};
+
+    int bestNeighbor = -1;
+    for (int u = 0; u < n; u++) {
+        if (u != bestVertex && a.at(bestVertex, u) < INF<Cost> &&
+            (bestNeighbor == -1 || a.at(bestVertex, u) < a.at(bestVertex, bestNeighbor)))
+            bestNeighbor = u;
+    }
+    if (bestNeighbor == -1) return {-1, -1};
+    return {bestVertex, bestNeighbor};
+}
+
+// Включение ребра (i, j): насыщенные вершины теряют остальные ребра,
+// а ребро, замыкающее цепочку раньше времени, запрещается.
+// Возвращает false, если тур достроить нельзя
+template <typename Cost>
+bool includeSymmetricEdge(SymmetricState<Cost>& state, int i, int j) {
+    TriangularMatrix<Cost>& a = state.available;
+    int n = a.n;
+
+    state.includedCost += a.at(i, j);
+    a.at(i, j) = INF<Cost>;
+    state.included.push_back({i, j});
+
+    for (int v : {i, j}) {
+        if (++state.degree[v] == 2) {
+            for (int u = 0; u < n; u++)
+                if (u != v) a.at(v, u) = INF<Cost>;
+        }
+    }
+
+    int endI = state.pathEnd[i], endJ = state.pathEnd[j];
+    state.pathEnd[endI] = endJ;
+    state.pathEnd[endJ] = endI;
+
+    if ((int)state.included.size() < n - 1) {
+        a.at(endI, endJ) = INF<Cost>;
+        return true;
+    }
+
+    // Осталось единственное ребро, замыкающее гамильтонов цикл
+    Cost closing = a.at(endI, endJ);
+    if (closing == INF<Cost>) return false;
+    state.includedCost += closing;
+    state.included.push_back({endI, endJ});
+    state.complete = true;
+    return true;
+}
+
+template <typename Cost>
+vector<pair<int, int>> littleSymmetricAlgorithm(const vector<vector<Cost>>& costMatrix, SearchStats* stats = nullptr,
+                                                NodePool<Cost>* sharedPool = nullptr) {
+    int n = costMatrix.size();
+    if (n < 4) return littleAlgorithm(costMatrix, stats, sharedPool);
+
+    if (DEBUG) cout << "\n--- Выполнение алгоритма Литтла (симметричная матрица) ---" << endl;
+    TELEMETRY_RUN("little-symmetric", n);
+
+    // Верхняя граница от локального поиска отсекает заведомо худшие ветви
+    vector<int> incumbent = localSearchAlgorithm(costMatrix);
+    Cost incumbentCost = incumbent.empty() ? INF<Cost> : calculateTotalCost(incumbent, costMatrix);
+    TELEMETRY_INCUMBENT_COST(incumbentCost);
+    if (DEBUG && !incumbent.empty()) cout << "Начальная верхняя граница: " << (double)incumbentCost << endl;
+
+    auto pathToEdges = [](const vector<int>& path) {
+        vector<pair<int, int>> edges;
+        for (size_t k = 0; k < path.size(); k++) edges.push_back({path[k], path[(k + 1) % path.size()]});
+        return edges;
+    };
+
+    // Буферы отсеченных вершин переходят к новым дочерним; общий пул
+    // сохраняет их и между экземплярами
+    NodePool<Cost> ownPool(0);
+    NodePool<Cost>& pool = sharedPool ? *sharedPool : ownPool;
+    pool.reset(n);
+    long long allocationsBefore = pool.allocations;
+    SymmetricState<Cost> root(costMatrix, pool);
+    // Для симметричного варианта вся оценка (1-дерево и степени) учитывается как mst
+    root.lowerBound = TELEMETRY_TIMED(mstNs, symmetricLowerBound(root));
+    if (DEBUG) cout << "Начальная нижняя граница: " << (double)root.lowerBound << endl;
+
+    // Куча поверх vector, как в несимметричном варианте: верхняя вершина
+    // перемещается, а не копируется
+    vector<SymmetricState<Cost>> pq;
+    auto pushChild = [&](SymmetricState<Cost>& child) {
+        if (!child.complete) child.lowerBound = TELEMETRY_TIMED(mstNs, symmetricLowerBound(child));
+        else child.lowerBound = child.includedCost;
+        if (child.lowerBound < incumbentCost) {
+            pq.push_back(move(child));
+            push_heap(pq.begin(), pq.end(), greater<SymmetricState<Cost>>());
+        } else {
+            TELEMETRY_COUNT(nodesPruned);
+            child.release(pool);
+        }
+    };
+    if (root.lowerBound < incumbentCost) pq.push_back(move(root));
+
+    int iterations = 0;
+    const int MAX_ITERATIONS_TO_SHOW = 3;
+
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), greater<SymmetricState<Cost>>());
+        SymmetricState<Cost> current = move(pq.back());
+        pq.pop_back();
+
+        iterations++;
+        TELEMETRY_EXPAND(current.lowerBound, pq.size() + 1);
+        bool showDetails = DEBUG && (iterations <= MAX_ITERATIONS_TO_SHOW);
+
+        if (stats) {
+            stats->allocations = pool.allocations - allocationsBefore;
+            stats->nodesExpanded++;
+            stats->peakQueueSize = max(stats->peakQueueSize, pq.size() + 1);
+            if (stats->nodeLimit && stats->nodesExpanded > stats->nodeLimit) {
+                stats->limitReached = true;
+                return {};
+            }
+        }
+
+        if (showDetails) {
+            cout << "\nИтерация " << iterations << ":" << endl;
+            cout << "Текущая нижняя граница: " << (double)current.lowerBound << endl;
+        }
+
+        // Первый извлеченный полный тур оптимален: у остальных граница не меньше
+        if (current.complete) {
+            vector<int> path;
+            vector<vector<int>> adjacent(n);
+            for (const auto& edge : current.included) {
+                adjacent[edge.first].push_back(edge.second);
+                adjacent[edge.second].push_back(edge.first);
+            }
+            int prev = -1, city = 0;
+            for (int k = 0; k < n; k++) {
+                path.push_back(city);
+                int to = adjacent[city][0] == prev ? adjacent[city][1] : adjacent[city][0];
+                prev = city;
+                city = to;
+            }
+            TELEMETRY_INCUMBENT_COST(current.includedCost);
+            return pathToEdges(path);
+        }
+
+        pair<int, int> edge = TELEMETRY_TIMED(branchingNs, findSymmetricBranchingEdge(current));
+        int i = edge.first, j = edge.second;
+        if (i == -1) {
+            TELEMETRY_COUNT(nodesPruned);
+            current.release(pool);
+            continue;
+        }
+
+        if (showDetails) cout << "Выбрано ребро для ветвления: {" << i << "," << j << "}" << endl;
+
+        // Ветвь 1: ребро {i, j} входит в тур
+        SymmetricState<Cost> includeState = current.copy(pool);
+        TELEMETRY_COUNT(includeBranches);
+        if (includeSymmetricEdge(includeState, i, j)) {
+            pushChild(includeState);
+        } else {
+            TELEMETRY_COUNT(nodesPruned);
+            includeState.release(pool);
+        }
+
+        // Ветвь 2: ребро {i, j} исключено
+        TELEMETRY_COUNT(excludeBranches);
+        current.available.at(i, j) = INF<Cost>;
+        pushChild(current);
+    }
+
+    if (stats) stats->allocations = pool.allocations - allocationsBefore;
+    TELEMETRY_PROVEN();
+    if (!incumbent.empty()) return pathToEdges(incumbent);
+
+    if (DEBUG) cout << "Решение не найдено\n" << endl;
+    return {};
+}
+
+void printPath(const vector<int>& path) {
+    cout << "Путь: ";
+    for (size_t i = 0; i < path.size(); i++) {
+        cout << path[i];
+        if (i + 1 < path.size()) cout << " -> ";
+    }
+    cout << " -> " << path[0] << endl;
+}
+
+// Чтение матрицы стоимостей: -1 означает отсутствие ребра
+vector<vector<double>> readCostMatrix(istream& in) {
+    // В конце потока n не читается и должно остаться нулевым
+    int n = 0;
+    in >> n;
+    if (n < 0) {
+        in.setstate(ios::failbit);
+        return {};
+    }
+
+    vector<vector<double>> input(n, vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            in >> input[i][j];
+    return input;
+}
+
+// Тип стоимостей выбирается по входу: для целых стоимостей - точная
+// целочисленная арифметика (int32, если границы заведомо помещаются, иначе
+// int64), для дробных - double
+enum class CostType { Int32, Int64, Double };
+
+CostType chooseCostType(const vector<vector<double>>& input) {
+    double n = input.size();
+    double maxCost = 0;
+
+    for (const auto& row : input) {
+        for (double val : row) {
+            if (val == -1) continue;
+            if (val != floor(val)) return CostType::Double;
+            maxCost = max(maxCost, fabs(val));
+        }
+    }
+
+    // Нижние границы накапливают редукции и MST по всей глубине дерева решений
+    double boundLimit = maxCost * (n + 2) * (n + 2);
+    if (boundLimit < numeric_limits<int32_t>::max() / 4) return CostType::Int32;
+    if (boundLimit < numeric_limits<int64_t>::max() / 4) return CostType::Int64;
+    return CostType::Double;
+}
+
+template <typename Cost>
+vector<vector<Cost>> convertCostMatrix(const vector<vector<double>>& input) {
+    int n = input.size();
+    vector<vector<Cost>> costMatrix(n, vector<Cost>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            costMatrix[i][j] = input[i][j] == -1 ? INF<Cost> : static_cast<Cost>(input[i][j]);
+    return costMatrix;
+}
+
+// Вызов solve с матрицей, приведенной к выбранному типу стоимостей
+template <typename Solve>
+auto dispatchCostType(const vector<vector<double>>& input, Solve solve) {
+    switch (chooseCostType(input)) {
+        case CostType::Int32: return solve(convertCostMatrix<int32_t>(input));
+        case CostType::Int64: return solve(convertCostMatrix<int64_t>(input));
+        default:              return solve(convertCostMatrix<double>(input));
+    }
+}
+
+int printLocalSearchResult(const vector<int>& path, double cost) {
+    cout << "\nЛокальный поиск (2-opt / Or-opt):" << endl;
+    if (path.empty()) {
+        cout << "no path" << endl;
+        return 0;
+    }
+
+    printPath(path);
+    cout << "Общая стоимость: " << fixed << setprecision(1) << cost << endl;
+    return 0;
+}
+
+// Режим "--points": число городов и их координаты
+int runLocalSearchOnPoints() {
+    int n;
+    cin >> n;
+
+    vector<pair<float, float>> points(n);
+    for (auto& p : points) cin >> p.first >> p.second;
+
+    vector<int> path = localSearchAlgorithm(points);
+    double cost = 0;
+    for (int i = 0; i < n; i++) {
+        const auto& a = points[path[i]];
+        const auto& b = points[path[(i + 1) % n]];
+        cost += hypot(a.first - b.first, a.second - b.second);
+    }
+    return printLocalSearchResult(path, cost);
+}
+
+// Режим "--ls": локальный поиск по матрице стоимостей
+template <typename Cost>
+int runLocalSearch(vector<vector<Cost>> costMatrix) {
+    for (size_t i = 0; i < costMatrix.size(); i++) costMatrix[i][i] = INF<Cost>;
+
+    vector<int> path = localSearchAlgorithm(costMatrix);
+    double cost = path.empty() ? 0 : calculateTotalCost(path, costMatrix);
+    return printLocalSearchResult(path, cost);
+}
+
+// Выбор варианта алгоритма Литтла по виду матрицы: для симметричной -
+// ветвление по неориентированным ребрам, для разреженной - хранение в CSR
+template <typename Cost>
+vector<pair<int, int>> solveExact(const vector<vector<Cost>>& costMatrix, NodePool<Cost>* pool = nullptr) {
+    if (isSymmetric(costMatrix)) return littleSymmetricAlgorithm(costMatrix, nullptr, pool);
+    if (isSparse(costMatrix)) return littleSparseAlgorithm(costMatrix, nullptr, pool);
+    return littleAlgorithm(costMatrix, nullptr, pool);
+}
+
+template <typename Cost>
+int solveAndPrint(const vector<vector<Cost>>& costMatrix) {
+    int n = costMatrix.size();
+    const vector<vector<Cost>>& originalCostMatrix = costMatrix;
+    
+    vector<int> absPath = nearestNeighborAlgorithm(originalCostMatrix);
+    // Для симметричной матрицы используется ветвление по неориентированным ребрам
+    vector<pair<int, int>> littleSolution = solveExact(costMatrix);
+    vector<int> littlePath = edgesToPath(littleSolution, n);
+    
+    double absCost = 0;
+    double littleCost = 0;
+
+    cout << "\n--- Результаты ---" << endl;
+    
+    cout << "Алгоритм ближайшего соседа (АБС):" << endl;
+    if (!absPath.empty()) {
+        cout << "Путь: ";
+        for (size_t i = 0; i < absPath.size(); i++) {
+            cout << absPath[i];
+            if (i + 1 < absPath.size()) cout << " -> ";
+        }
+        cout << " -> " << absPath[0] << endl;
+        
+        absCost = calculateTotalCost(absPath, originalCostMatrix);
+        cout << "Общая стоимость: " << fixed << setprecision(1) << absCost << endl;
+    } 
+    
+    cout << "\nАлгоритм Литтла:" << endl;
+    if (!littlePath.empty()) {
+        cout << "Путь: ";
+        for (size_t i = 0; i < littlePath.size(); i++) {
+            cout << littlePath[i];
+            if (i + 1 < littlePath.size()) cout << " -> ";
+        }
+        cout << " -> " << littlePath[0] << endl;
+        
+        littleCost = calculateTotalCost(littlePath, originalCostMatrix);
+        cout << "Общая стоимость: " << fixed << setprecision(1) << littleCost << endl;
+    }
+    
+    // Если оба алгоритма нашли решение, выводим сравнение
+    if (!absPath.empty() && !littlePath.empty()) {
+        double ratio = absCost / littleCost;
+        cout << "\nОтношение АБС/Литтл: " << fixed << setprecision(2) << ratio << endl;
+    }
+    else if (absPath.empty() && littlePath.empty()) {
+        cout << "no path" << endl;
+    }
+    
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Пакетный режим "--batch [потоки]": поток экземпляров в формате входа
+// решается на фиксированном пуле потоков. Трассировка отключается, для
+// каждого экземпляра в порядке входа печатается одна строка:
+// "стоимость вершина вершина ..." или "no path".
+// ---------------------------------------------------------------------------
+
+// Пулы буферов вершин одного потока, общие для всех его экземпляров
+struct WorkerPools {
+    NodePool<int32_t> int32Pool{0};
+    NodePool<int64_t> int64Pool{0};
+    NodePool<double> doublePool{0};
+
+    template <typename Cost>
+    NodePool<Cost>& get() {
+        if constexpr (is_same_v<Cost, int32_t>) return int32Pool;
+        else if constexpr (is_same_v<Cost, int64_t>) return int64Pool;
+        else return doublePool;
+    }
+};
+
+template <typename Cost>
+string solveBatchInstance(const vector<vector<Cost>>& costMatrix, WorkerPools& pools) {
+    int n = costMatrix.size();
+    vector<pair<int, int>> solution = solveExact(costMatrix, &pools.get<Cost>());
+    vector<int> path = edgesToPath(solution, n);
+    if (path.empty()) return "no path";
+
+    ostringstream line;
+    line << fixed << setprecision(1) << (double)calculateTotalCost(path, costMatrix);
+    for (int v : path) line << ' ' << v;
+    return line.str();
+}
+
+int runBatch(int threadCount) {
+    DEBUG = false;
+
+    // Очередь прочитанных экземпляров ограничена, чтобы чтение не убегало
+    // далеко вперед решения
+    const size_t maxPending = 4 * threadCount;
+    mutex queueMutex;
+    condition_variable hasWork, hasSpace;
+    deque<pair<size_t, vector<vector<double>>>> pending;
+    bool inputDone = false;
+
+    // Готовые строки ждут, пока не будут напечатаны все предыдущие
+    mutex outputMutex;
+    map<size_t, string> finished;
+    size_t nextToPrint = 0;
+
+    auto worker = [&]() {
+        WorkerPools pools;
+        while (true) {
+            pair<size_t, vector<vector<double>>> task;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                hasWork.wait(lock, [&] { return !pending.empty() || inputDone; });
+                if (pending.empty()) return;
+                task = move(pending.front());
+                pending.pop_front();
+            }
+            hasSpace.notify_one();
+
+            string line = dispatchCostType(task.second, [&](auto costMatrix) {
+                return solveBatchInstance(costMatrix, pools);
+            });
+
+            lock_guard<mutex> lock(outputMutex);
+            finished[task.first] = move(line);
+            for (auto it = finished.begin(); it != finished.end() && it->first == nextToPrint; it = finished.erase(it)) {
+                cout << it->second << '\n';
+                nextToPrint++;
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 0; t < threadCount; t++) workers.emplace_back(worker);
+
+    // Вход заканчивается только между экземплярами; оборванный или
+    // нечитаемый экземпляр - ошибка, уже прочитанные при этом решаются
+    int status = 0;
+    for (size_t index = 0;; index++) {
+        vector<vector<double>> input = readCostMatrix(cin);
+        if (cin.fail() && input.empty() && cin.eof()) break;
+        if (cin.fail() || input.empty()) {
+            cerr << "Экземпляр " << index + 1 << " во входе неполон или некорректен" << endl;
+            status = 1;
+            break;
+        }
+
+        unique_lock<mutex> lock(queueMutex);
+        hasSpace.wait(lock, [&] { return pending.size() < maxPending; });
+        pending.push_back({index, move(input)});
+        lock.unlock();
+        hasWork.notify_one();
+    }
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        inputDone = true;
+    }
+    hasWork.notify_all();
+    for (auto& w : workers) w.join();
+
+    cout.flush();
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    string mode = argc > 1 ? argv[1] : "";
+    TELEMETRY_WRITE_AT_EXIT();
+    if (mode == "--points") return runLocalSearchOnPoints();
+    if (mode == "--batch") {
+        int threads = max((int)thread::hardware_concurrency(), 1);
+        if (argc > 2) {
+            char* end = nullptr;
+            long value = strtol(argv[2], &end, 10);
+            if (end == argv[2] || *end != '\0' || value < 1 || value > 1024) {
+                cerr << "Число потоков должно быть целым от 1 до 1024: " << argv[2] << endl;
+                return 1;
+            }
+            threads = value;
+        }
+        return runBatch(threads);
+    }
+
+    vector<vector<double>> input = readCostMatrix(cin);
+
+    if (mode == "--ls") {
+        return dispatchCostType(input, [](const auto& costMatrix) { return runLocalSearch(costMatrix); });
+    }
+    return dispatchCostType(input, [](const auto& costMatrix) { return solveAndPrint(costMatrix); });
 }
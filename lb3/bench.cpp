@@ -0,0 +1,379 @@
+// Бенчмарк алгоритмов редакционного расстояния из task1.cpp, task12.cpp,
+// task2.cpp и task3.cpp.
+//
+// Сборка:  g++ -std=c++17 -O2 -pthread -o bench bench.cpp
+// Запуск:  ./bench [seed] [длина ...] > results.csv
+//
+// Генерирует с фиксированным зерном пары строк для набора длин, размеров
+// алфавита и степеней сходства (доля символов B, оставшихся от A). Короткие
+// пары собираются в наборы примерно из 2^20 клеток, чтобы время было
+// измеримым. Для каждого набора и каждого применимого алгоритма печатает
+// строку CSV: время, клетки dp в секунду, пиковый объём кучи и число
+// выделений памяти за прогон. Расстояния всех алгоритмов сверяются с
+// построчным dp на int64_t; при расхождении строка помечается mismatch,
+// а программа завершается с кодом 1.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <condition_variable>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <random>
+#include <malloc.h>
+
+// Файлы задач объявляют одинаковые имена (minEditDistance), поэтому каждый
+// включается в своё пространство имён. Все их заголовки, в том числе общие
+// mapped_file.h, myers_column.h и cell_type.h, подключены выше: внутри
+// пространства имён повторное включение ничего не делает
+#include "mapped_file.h"
+#include "myers_column.h"
+#include "cell_type.h"
+
+#define main task1Main
+namespace task1 {
+#include "task1.cpp"
+}
+#undef main
+
+#define main task12Main
+namespace task12 {
+#include "task12.cpp"
+}
+#undef main
+
+#define main task2Main
+namespace task2 {
+#include "task2.cpp"
+}
+#undef main
+
+#define main task3Main
+namespace task3 {
+#include "task3.cpp"
+}
+#undef main
+
+// Счётчики кучи: глобальные operator new/delete заменены ниже. Размер блока
+// берётся из malloc_usable_size, поэтому заголовок перед блоком не нужен.
+// Все формы new выделяют через acquire, все формы delete освобождают через
+// release: пара malloc/aligned_alloc и free собрана в одном месте и не
+// встраивается в места вызова new и delete
+namespace heap {
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> live{0};
+std::atomic<size_t> peak{0};
+
+__attribute__((noinline)) void* acquire(size_t size, size_t alignment) {
+    void* p;
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        p = std::malloc(size ? size : 1);
+    } else {
+        // aligned_alloc требует размер, кратный выравниванию
+        p = aligned_alloc(alignment, std::max(alignment, (size + alignment - 1) / alignment * alignment));
+    }
+    if (!p) throw std::bad_alloc();
+
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t now = live.fetch_add(malloc_usable_size(p), std::memory_order_relaxed) + malloc_usable_size(p);
+    size_t seen = peak.load(std::memory_order_relaxed);
+    while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+    return p;
+}
+
+__attribute__((noinline)) void release(void* p) noexcept {
+    if (!p) return;
+    live.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+// Начало замера: пик отсчитывается от текущего объёма
+void reset() {
+    allocations = 0;
+    peak = live.load();
+}
+}
+
+void* operator new(size_t size) {
+    return heap::acquire(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    return heap::acquire(size, static_cast<size_t>(align));
+}
+
+void operator delete(void* p) noexcept {
+    heap::release(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    heap::release(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    heap::release(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    heap::release(p);
+}
+
+using StringPair = std::pair<std::string, std::string>;
+
+struct Costs {
+    std::string name;
+    int64_t repl, ins, del;
+
+    bool unit() const { return repl == ins && ins == del; }
+};
+
+struct Case {
+    std::string name;
+    size_t length = 0;
+    int alphabet = 0;
+    double similarity = 0;
+    std::vector<StringPair> pairs;
+    size_t cells = 0;  // Сумма m * n по парам набора
+};
+
+// Клеток в наборе коротких пар
+const size_t CASE_CELLS = size_t(1) << 20;
+
+std::string randomString(size_t length, int alphabet, std::mt19937& rng) {
+    std::uniform_int_distribution<int> symbol(0, alphabet - 1);
+    std::string s(length, 'a');
+    for (char& c : s) c = 'a' + symbol(rng);
+    return s;
+}
+
+// Копия A, в которой каждый символ с вероятностью 1 - similarity заменён,
+// удалён или дополнен вставкой; при similarity = 0 строки почти независимы
+std::string mutate(const std::string& A, double similarity, int alphabet, std::mt19937& rng) {
+    std::uniform_real_distribution<double> keep(0, 1);
+    std::uniform_int_distribution<int> symbol(0, alphabet - 1), operation(0, 2);
+    std::string B;
+    B.reserve(A.length() + A.length() / 4);
+    for (char c : A) {
+        if (keep(rng) < similarity) {
+            B += c;
+            continue;
+        }
+        switch (operation(rng)) {
+            case 0: B += 'a' + symbol(rng); break;
+            case 1: break;
+            default: B += c; B += 'a' + symbol(rng); break;
+        }
+    }
+    return B;
+}
+
+Case generateCase(size_t length, int alphabet, double similarity, unsigned seed) {
+    std::seed_seq seq{seed, (unsigned)length, (unsigned)alphabet, (unsigned)(similarity * 100)};
+    std::mt19937 rng(seq);
+
+    Case c;
+    c.name = "len" + std::to_string(length) + "-a" + std::to_string(alphabet) + "-s" +
+             std::to_string((int)(similarity * 100)) + "-" + std::to_string(seed);
+    c.length = length;
+    c.alphabet = alphabet;
+    c.similarity = similarity;
+
+    size_t count = std::max<size_t>(1, CASE_CELLS / std::max<size_t>(1, length * length));
+    for (size_t p = 0; p < count; p++) {
+        std::string A = randomString(length, alphabet, rng);
+        std::string B = mutate(A, similarity, alphabet, rng);
+        c.cells += A.length() * B.length();
+        c.pairs.emplace_back(std::move(A), std::move(B));
+    }
+    return c;
+}
+
+// Строки без общих символов: клетки таблицы доходят до своей оценки
+// max(m, n) * max(стоимость), на которой выбирается ширина клетки
+Case disjointCase(size_t length) {
+    Case c;
+    c.name = "len" + std::to_string(length) + "-disjoint";
+    c.length = length;
+    c.alphabet = 2;
+    size_t count = std::max<size_t>(1, CASE_CELLS / std::max<size_t>(1, length * length));
+    for (size_t p = 0; p < count; p++) {
+        c.cells += length * length;
+        c.pairs.emplace_back(std::string(length, 'a'), std::string(length, 'b'));
+    }
+    return c;
+}
+
+struct RunResult {
+    std::string engine;
+    double timeMs = 0;
+    size_t peakHeap = 0;
+    size_t allocations = 0;
+    std::vector<int64_t> distances;
+};
+
+using Engine = std::function<std::vector<int64_t>(const std::vector<StringPair>&)>;
+
+// Алгоритм над одной парой, применённый к каждой паре набора
+template <typename Solve>
+Engine perPair(Solve solve) {
+    return [solve](const std::vector<StringPair>& pairs) {
+        std::vector<int64_t> distances(pairs.size());
+        for (size_t p = 0; p < pairs.size(); p++) distances[p] = solve(pairs[p].first, pairs[p].second);
+        return distances;
+    };
+}
+
+RunResult runEngine(const std::string& name, const Engine& engine, const std::vector<StringPair>& pairs) {
+    RunResult result;
+    result.engine = name;
+
+    const size_t liveBefore = heap::live.load();
+    heap::reset();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int64_t> distances = engine(pairs);
+    auto finish = std::chrono::steady_clock::now();
+    result.peakHeap = heap::peak.load() - liveBefore;
+    result.allocations = heap::allocations.load();
+
+    result.timeMs = std::chrono::duration<double, std::milli>(finish - start).count();
+    result.distances = std::move(distances);
+    return result;
+}
+
+// Пиковая куча - сверх объёма, занятого на входе в прогон
+void printResult(const Case& c, const Costs& costs, const RunResult& r, bool match) {
+    double cellsPerSecond = r.timeMs > 0 ? c.cells / (r.timeMs / 1000) : 0;
+    std::cout << c.name << ',' << c.length << ',' << c.pairs.size() << ',' << c.alphabet << ','
+              << std::fixed << std::setprecision(2) << c.similarity << ',' << costs.name << ','
+              << r.engine << ',' << std::setprecision(3) << r.timeMs << ','
+              << std::setprecision(0) << cellsPerSecond << ',' << r.peakHeap << ','
+              << r.allocations << ',' << (match ? "ok" : "mismatch") << std::endl;
+}
+
+// Все применимые алгоритмы на наборе; возвращает число расхождений с эталоном
+int benchmarkCase(const Case& c, const Costs& costs) {
+    const int64_t repl = costs.repl, ins = costs.ins, del = costs.del;
+    std::vector<std::pair<std::string, Engine>> engines;
+
+    // Эталон - построчный dp в int64_t без выбора ширины клетки
+    engines.emplace_back("task1-row-int64", perPair([=](const std::string& A, const std::string& B) {
+        return task1::minEditDistanceRow<int64_t>(A, B, repl, ins, del);
+    }));
+    engines.emplace_back("task1-minEditDistance", perPair([=](const std::string& A, const std::string& B) {
+        return task1::minEditDistance(A, B, repl, ins, del);
+    }));
+    // Тайлы на int32_t без выбора ширины - только пока клетка с прибавленной
+    // стоимостью в нем помещается
+    const int64_t maxCost = std::max({repl, ins, del});
+    if (c.length >= task1::TILE_SIZE && maxCost <= INT32_MAX / (int64_t)(c.length * 2 + 1)) {
+        engines.emplace_back("task1-tiled-int32", perPair([=](const std::string& A, const std::string& B) {
+            return task1::minEditDistanceTiled<int32_t>(A, B, repl, ins, del, std::thread::hardware_concurrency());
+        }));
+    }
+    if (costs.unit()) {
+        engines.emplace_back("task1-myers", perPair([=](const std::string& A, const std::string& B) {
+            return repl * task1::myersDistance(A, B);
+        }));
+    }
+    engines.emplace_back("task1-batch", [=](const std::vector<StringPair>& pairs) {
+        return task1::minEditDistanceBatch(pairs, repl, ins, del, std::thread::hardware_concurrency());
+    });
+
+    const task12::CostTable table(repl, ins, del);
+    engines.emplace_back("task12-table", perPair([&table](const std::string& A, const std::string& B) {
+        return task12::minEditDistance(A, B, table);
+    }));
+
+    if ((c.length + 1) * (c.length + 1) <= task2::MAX_TABLE_CELLS) {
+        engines.emplace_back("task2-table", perPair([=](const std::string& A, const std::string& B) {
+            return task2::getEditSequenceTable(A, B, repl, ins, del).first;
+        }));
+    }
+    engines.emplace_back("task2-hirschberg", perPair([=](const std::string& A, const std::string& B) {
+        return task2::getEditSequenceHirschberg(A, B, repl, ins, del).first;
+    }));
+
+    if (costs.unit()) {
+        engines.emplace_back("task3-levenshtein", perPair([=](const std::string& A, const std::string& B) {
+            return repl * task3::levenshteinDistance(A, B);
+        }));
+    }
+
+    int mismatches = 0;
+    std::vector<int64_t> reference;
+    for (const auto& [name, engine] : engines) {
+        RunResult r = runEngine(name, engine, c.pairs);
+        if (reference.empty()) reference = r.distances;
+        bool match = r.distances == reference;
+        if (!match) {
+            mismatches++;
+            for (size_t p = 0; p < reference.size(); p++) {
+                if (r.distances[p] == reference[p]) continue;
+                std::cerr << c.name << ' ' << costs.name << ' ' << name << ": пара " << p
+                          << " расстояние " << r.distances[p] << ", эталон " << reference[p] << std::endl;
+                break;
+            }
+        }
+        printResult(c, costs, r, match);
+    }
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned seed = argc > 1 ? std::stoul(argv[1]) : 1;
+    std::vector<size_t> lengths = {8, 64, 1000, 10000};
+    if (argc > 2) {
+        lengths.clear();
+        for (int i = 2; i < argc; i++) lengths.push_back(std::stoul(argv[i]));
+    }
+    const std::vector<int> alphabets = {2, 4, 26};
+    const std::vector<double> similarities = {0.0, 0.9};
+    // Крупные стоимости проверяют границы узких типов: 254 - наибольшая
+    // стоимость, при которой пары ещё идут в 16-битные полосы пакета; 31 и
+    // 1023 переводят оценку клетки m * max(стоимость) через границы uint8_t
+    // и uint16_t для длин около 8 и 64, 214748 - через границу int32_t для
+    // длины 10000 (m * 214748 в int32_t помещается, (m + 1) * 214748 - нет);
+    // 511 - прежнее переполнение полос
+    const std::vector<Costs> costSets = {{"unit", 1, 1, 1}, {"weighted", 3, 2, 4}, {"large", 511, 511, 511},
+                                         {"lane-limit", 254, 253, 254}, {"cell8-limit", 31, 30, 31},
+                                         {"cell16-limit", 1023, 1021, 1023}, {"cell32-limit", 214747, 214748, 214748}};
+
+    std::cout << "case,length,pairs,alphabet,similarity,costs,engine,time_ms,cells_per_sec,peak_heap_bytes,allocations,status" << std::endl;
+
+    int mismatches = 0;
+    for (size_t length : lengths) {
+        for (int alphabet : alphabets) {
+            for (double similarity : similarities) {
+                Case c = generateCase(length, alphabet, similarity, seed);
+                for (const Costs& costs : costSets) mismatches += benchmarkCase(c, costs);
+            }
+        }
+        Case c = disjointCase(length);
+        for (const Costs& costs : costSets) mismatches += benchmarkCase(c, costs);
+    }
+
+    if (mismatches) {
+        std::cerr << "Расхождений с эталоном: " << mismatches << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef CELL_TYPE_H
+#define CELL_TYPE_H
+
+#include <cstdint>
+
+// Вызывает kernel с наименьшим типом клетки, в который помещается bound;
+// отрицательная оценка означает, что узкие типы не подходят
+template <typename Kernel>
+auto dispatchCellType(int64_t bound, Kernel kernel) {
+    if (bound < 0) return kernel(int64_t{});
+    if (bound <= UINT8_MAX) return kernel(uint8_t{});
+    if (bound <= UINT16_MAX) return kernel(uint16_t{});
+    if (bound <= INT32_MAX) return kernel(int32_t{});
+    return kernel(int64_t{});
+}
+
+#endif
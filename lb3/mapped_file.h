@@ -0,0 +1,53 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Файл, отображённый в память только для чтения: строки длиной в гигабайты
+// передаются в алгоритмы как string_view, без копирования через потоки
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    ~MappedFile() {
+        if (data != MAP_FAILED) munmap(data, length);
+    }
+    
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            return false;
+        }
+        length = info.st_size;
+        // Пустой файл не отображается: mmap нулевой длины - ошибка
+        if (length > 0) data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        return length == 0 || data != MAP_FAILED;
+    }
+    
+    std::string_view bytes() const {
+        return length ? std::string_view(static_cast<const char*>(data), length) : std::string_view();
+    }
+    
+    // Содержимое без завершающего перевода строки
+    std::string_view sequence() const {
+        std::string_view view = bytes();
+        while (!view.empty() && (view.back() == '\n' || view.back() == '\r')) view.remove_suffix(1);
+        return view;
+    }
+    
+private:
+    void* data = MAP_FAILED;
+    size_t length = 0;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef MYERS_COLUMN_H
+#define MYERS_COLUMN_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Столбец dp по образцу для битово-параллельного алгоритма Майерса в блочном
+// варианте Хиерё (все стоимости 1). Столбец хранится как векторы приращений
+// +1/-1 между соседними клетками, по 64 клетки в слове; символ текста
+// обрабатывается за O(m/64) словесных операций. Таблица образца строится
+// один раз, поэтому после reset() тот же образец сравнивается с другим текстом.
+class MyersColumn {
+public:
+    explicit MyersColumn(std::string_view pattern)
+        : m(pattern.length()), blocks((m + 63) / 64), lastBit(m ? (m - 1) % 64 : 0) {
+        // peq[c][b] - позиции символа c в блоке b образца. Строки таблицы заведены
+        // только для символов образца, остальным соответствует нулевая строка 0
+        size_t symbols = 1;
+        for (unsigned char c : pattern) {
+            if (!symbol[c]) symbol[c] = symbols++;
+        }
+        peq.assign(symbols * blocks, 0);
+        for (size_t i = 0; i < m; i++) {
+            peq[symbol[(unsigned char)pattern[i]] * blocks + i / 64] |= uint64_t(1) << (i % 64);
+        }
+        reset();
+    }
+    
+    // Начальный столбец dp[i][0] = i: все вертикальные приращения +1
+    void reset() {
+        pv.assign(blocks, ~uint64_t(0));
+        mv.assign(blocks, 0);
+    }
+    
+    // Переход к следующему столбцу по символу текста c. carry - горизонтальное
+    // приращение над первым блоком: 1, если dp[0][j] = j, и 0, если начало
+    // текста бесплатно. Возвращает приращение в последней строке столбца
+    int step(unsigned char c, int carry) {
+        const uint64_t* eq = &peq[symbol[c] * blocks];
+        
+        for (size_t b = 0; b < blocks; b++) {
+            uint64_t Pv = pv[b], Mv = mv[b], Eq = eq[b];
+            uint64_t carryPlus = carry > 0, carryMinus = carry < 0;
+            
+            uint64_t Xv = Eq | Mv;
+            Eq |= carryMinus;
+            uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+            uint64_t Ph = Mv | ~(Xh | Pv);
+            uint64_t Mh = Pv & Xh;
+            
+            // Приращение на нижней клетке блока переходит в следующий блок
+            int bit = b + 1 < blocks ? 63 : lastBit;
+            carry = (int)((Ph >> bit) & 1) - (int)((Mh >> bit) & 1);
+            
+            Ph = (Ph << 1) | carryPlus;
+            Mh = (Mh << 1) | carryMinus;
+            pv[b] = Mh | ~(Xv | Ph);
+            mv[b] = Ph & Xv;
+        }
+        
+        return carry;
+    }
+    
+private:
+    size_t m, blocks;
+    int lastBit;
+    std::array<size_t, 256> symbol{};
+    std::vector<uint64_t> peq, pv, mv;
+};
+
+#endif
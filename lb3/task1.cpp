@@ -2,46 +2,578 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string_view>
+#include "mapped_file.h"
+#include "myers_column.h"
+#include "cell_type.h"
 
-int64_t minEditDistance(const std::string& A, const std::string& B, 
-                       int64_t replCost, int64_t insCost, int64_t delCost) {
+// Расстояние Левенштейна; образцом берётся более короткая строка
+int64_t myersDistance(std::string_view source, std::string_view target) {
+    std::string_view pattern = source.length() <= target.length() ? source : target;
+    std::string_view text = source.length() <= target.length() ? target : source;
+    if (pattern.empty()) return text.length();
+    
+    MyersColumn column(pattern);
+    int64_t score = pattern.length();
+    for (unsigned char c : text) {
+        score += column.step(c, 1);
+    }
+    return score;
+}
+
+// Ширина векторного регистра цели для векторных расширений GCC
+#ifdef __AVX2__
+constexpr size_t VECTOR_BYTES = 32;
+#else
+constexpr size_t VECTOR_BYTES = 16;
+#endif
+
+// Начиная с этого числа клеток произвольные стоимости считаются тайлами в
+// несколько потоков
+const size_t MIN_TILED_CELLS = size_t(1) << 26;
+// Сторона тайла: строка тайла и буферы помещаются в L1/L2
+const size_t TILE_SIZE = 256;
+
+// Барьер между антидиагоналями тайлов
+class DiagonalBarrier {
+public:
+    explicit DiagonalBarrier(size_t count) : count(count) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t current = generation;
+        if (++waiting == count) {
+            waiting = 0;
+            generation++;
+            released.notify_all();
+        } else {
+            released.wait(lock, [&] { return generation != current; });
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    size_t count, waiting = 0, generation = 0;
+};
+
+// Замена (или совпадение) и удаление для строки тайла: out[j] по prev[j-1] и
+// prev[j]. Зависимости только от предыдущей строки, поэтому строка идёт
+// векторами по VECTOR_BYTES; b - символы B, расширенные до Cell
+template <typename Cell>
+void replaceDeleteRow(const Cell* prev, const Cell* b, Cell a, Cell repl, Cell del, Cell* out, size_t w) {
+    typedef Cell Lanes __attribute__((vector_size(VECTOR_BYTES)));
+    const size_t lanes = sizeof(Lanes) / sizeof(Cell);
+    const Lanes aLanes = (Lanes){} + a, replLanes = (Lanes){} + repl, delLanes = (Lanes){} + del;
+    
+    size_t j = 1;
+    for (; j + lanes <= w + 1; j += lanes) {
+        Lanes diag, up, chars;
+        std::memcpy(&diag, prev + j - 1, sizeof(Lanes));
+        std::memcpy(&up, prev + j, sizeof(Lanes));
+        std::memcpy(&chars, b + j - 1, sizeof(Lanes));
+        Lanes replOp = diag + (chars == aLanes ? (Lanes){} : replLanes);
+        Lanes delOp = up + delLanes;
+        Lanes best = replOp < delOp ? replOp : delOp;
+        std::memcpy(out + j, &best, sizeof(Lanes));
+    }
+    for (; j <= w; j++) {
+        Cell replOp = prev[j-1] + (a == b[j-1] ? 0 : repl);
+        Cell delOp = prev[j] + del;
+        out[j] = replOp < delOp ? replOp : delOp;
+    }
+}
+
+// Стоимость при произвольных неотрицательных стоимостях операций: таблица
+// делится на тайлы TILE_SIZE x TILE_SIZE, тайлы одной антидиагонали
+// независимы и считаются параллельно. Общие данные - только границы тайлов:
+// нижние строки (H) и правые столбцы (V). Тайл диагонали d пишет границы в
+// буферы d % 3, верх и левый край читает из (d - 1) % 3, угол - из (d - 2) % 3,
+// поэтому соседние диагонали не затирают нужные друг другу значения.
+template <typename Cell>
+int64_t minEditDistanceTiled(std::string_view A, std::string_view B,
+                             Cell replCost, Cell insCost, Cell delCost, unsigned threads) {
     const size_t m = A.length();
     const size_t n = B.length();
+    const size_t tileRows = (m + TILE_SIZE - 1) / TILE_SIZE;
+    const size_t tileCols = (n + TILE_SIZE - 1) / TILE_SIZE;
     
-    // dp[i][j] - минимальная стоимость преобразования префикса A[0..i-1] в префикс B[0..j-1]
-    std::vector<std::vector<int64_t>> dp(m + 1, std::vector<int64_t>(n + 1, 0));
-    
-    // Инициализация первой строки и столбца
-    for (size_t i = 0; i <= m; i++) {
-        dp[i][0] = i * delCost;
+    std::vector<Cell> H[3], V[3];
+    for (int b = 0; b < 3; b++) {
+        H[b].assign(n + 1, 0);
+        V[b].assign(m + 1, 0);
     }
+    
+    // Тайл (r, c) на диагонали d: вход - верхняя строка с углом и левый столбец
+    auto computeTile = [&](size_t r, size_t c, size_t d, std::vector<Cell>& row, std::vector<Cell>& diagUp,
+                           std::vector<Cell>& bWide) {
+        const size_t i0 = r * TILE_SIZE, j0 = c * TILE_SIZE;
+        const size_t h = std::min(TILE_SIZE, m - i0), w = std::min(TILE_SIZE, n - j0);
+        const std::vector<Cell>& top = H[(d + 2) % 3];
+        const std::vector<Cell>& left = V[(d + 2) % 3];
+        std::vector<Cell>& bottom = H[d % 3];
+        std::vector<Cell>& right = V[d % 3];
+        
+        if (r == 0) row[0] = j0 * insCost;
+        else if (c == 0) row[0] = i0 * delCost;
+        else row[0] = H[(d + 1) % 3][j0];
+        for (size_t j = 1; j <= w; j++) row[j] = r == 0 ? (j0 + j) * insCost : top[j0 + j];
+        
+        for (size_t j = 0; j < w; j++) bWide[j] = (unsigned char)B[j0 + j];
+        for (size_t i = 1; i <= h; i++) {
+            replaceDeleteRow<Cell>(row.data(), bWide.data(), (unsigned char)A[i0 + i - 1],
+                                   replCost, delCost, diagUp.data(), w);
+            // Вставка - последовательный проход по строке
+            Cell current = c == 0 ? (i0 + i) * delCost : left[i0 + i];
+            row[0] = current;
+            for (size_t j = 1; j <= w; j++) {
+                Cell insOp = current + insCost;
+                current = diagUp[j] < insOp ? diagUp[j] : insOp;
+                row[j] = current;
+            }
+            right[i0 + i] = row[w];
+        }
+        for (size_t j = 1; j <= w; j++) bottom[j0 + j] = row[j];
+    };
+    
+    threads = std::max(1u, std::min<unsigned>(threads, std::min(tileRows, tileCols)));
+    DiagonalBarrier barrier(threads);
+    
+    auto worker = [&](unsigned t) {
+        std::vector<Cell> row(TILE_SIZE + 1), diagUp(TILE_SIZE + 1), bWide(TILE_SIZE);
+        for (size_t d = 0; d + 1 < tileRows + tileCols; d++) {
+            size_t rFirst = d + 1 > tileCols ? d + 1 - tileCols : 0;
+            size_t rLast = std::min(d, tileRows - 1);
+            for (size_t r = rFirst + t; r <= rLast; r += threads) {
+                computeTile(r, d - r, d, row, diagUp, bWide);
+            }
+            barrier.wait();
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& thread : pool) thread.join();
+    
+    // Правый нижний тайл лежит на последней диагонали
+    return H[(tileRows + tileCols - 2) % 3][n];
+}
+
+// Построчный dp для произвольных стоимостей; клетки строки хранятся в типе
+// Cell, в который помещается любое значение таблицы, сами операции - в int64_t
+template <typename Cell>
+int64_t minEditDistanceRow(std::string_view A, std::string_view B,
+                           int64_t replCost, int64_t insCost, int64_t delCost) {
+    const size_t m = A.length();
+    const size_t n = B.length();
+    
+    // row[j] - минимальная стоимость преобразования префикса A[0..i-1] в префикс B[0..j-1]
+    // для текущего i; хранится одна строка таблицы, память O(min(m, n))
+    std::vector<Cell> row(n + 1);
+    
+    // Инициализация первой строки
     for (size_t j = 0; j <= n; j++) {
-        dp[0][j] = j * insCost;
+        row[j] = j * insCost;
     }
     
-    // Заполнение таблицы dp
+    // Заполнение таблицы dp по строкам
     for (size_t i = 1; i <= m; i++) {
+        int64_t diag = row[0];  // dp[i-1][j-1]
+        row[0] = i * delCost;
+        
         for (size_t j = 1; j <= n; j++) {
+            int64_t up = row[j];  // dp[i-1][j]
+            
             if (A[i-1] == B[j-1]) {
-                dp[i][j] = dp[i-1][j-1];
+                row[j] = diag;
             } else {
                 // Минимум из трех операций:
                 // 1. Замена (replace)
                 // 2. Вставка (insert)
                 // 3. Удаление (delete)
-                dp[i][j] = std::min({
-                    dp[i-1][j-1] + replCost,  // replace
-                    dp[i][j-1] + insCost,     // insert
-                    dp[i-1][j] + delCost      // delete
+                row[j] = std::min({
+                    diag + replCost,                // replace
+                    (int64_t)row[j-1] + insCost,    // insert
+                    up + delCost                    // delete
                 });
             }
+            diag = up;
         }
     }
     
-    return dp[m][n];
+    return row[n];
+}
+
+int64_t minEditDistance(std::string_view A, std::string_view B,
+                       int64_t replCost, int64_t insCost, int64_t delCost) {
+    // При равных стоимостях ответ - расстояние Левенштейна, умноженное на стоимость
+    if (replCost == insCost && insCost == delCost && replCost >= 0) {
+        return replCost * myersDistance(A, B);
+    }
+
+    // Строка dp идет по более короткой строке. Если короче A, строки меняются
+    // местами: преобразование B в A, в котором вставки и удаления меняются ролями
+    if (A.length() < B.length()) {
+        return minEditDistance(B, A, replCost, delCost, insCost);
+    }
+
+    const size_t m = A.length();
+    const size_t n = B.length();
+    
+    // Клетка таблицы не больше max(m, n) * max(стоимость) = m * max(стоимость),
+    // а тайл до взятия минимума прибавляет к клетке еще одну стоимость
+    // операции. По оценке (m + 1) * max(стоимость) клетки хранятся в самом
+    // узком подходящем типе
+    const int64_t maxCost = std::max({replCost, insCost, delCost});
+    int64_t bound = -1;
+    if (std::min({replCost, insCost, delCost}) >= 0 && maxCost <= INT64_MAX / (int64_t)(m + 1)) {
+        bound = (m + 1) * maxCost;
+    }
+    
+    return dispatchCellType(bound, [&](auto cell) {
+        using Cell = decltype(cell);
+        // Длинные строки при неотрицательных стоимостях считаются параллельно.
+        // Последовательный проход вставок в тайле на 8- и 16-битных клетках
+        // медленнее, чем на 32-битных, поэтому тайлы не уже int32_t
+        if (m * n >= MIN_TILED_CELLS && bound >= 0) {
+            using TileCell = std::conditional_t<(sizeof(Cell) < sizeof(int32_t)), int32_t, Cell>;
+            return minEditDistanceTiled<TileCell>(A, B, replCost, insCost, delCost,
+                                                  std::thread::hardware_concurrency());
+        }
+        return minEditDistanceRow<Cell>(A, B, replCost, insCost, delCost);
+    });
 }
 
-int main() {
+// Поиск окна текста, ближайшего к образцу A (полуглобальное выравнивание):
+// начало окна бесплатно, dp[0][j] = 0, и конец тоже - ответом служит
+// каждая позиция текста, где dp[m][j] <= k. Текст подаётся кусками по мере
+// чтения, состояние - один столбец dp. При равных стоимостях столбец ведётся
+// битово-параллельно (Майерс с нулевым приращением над первым блоком).
+class ApproximateSearch {
+public:
+    ApproximateSearch(std::string_view pattern, int64_t replCost, int64_t insCost, int64_t delCost, int64_t k)
+        : pattern(pattern), replCost(replCost), insCost(insCost), delCost(delCost), k(k),
+          unitCost(replCost == insCost && insCost == delCost && replCost >= 0),
+          myers(pattern), score(pattern.length()), column(pattern.length() + 1) {
+        for (size_t i = 0; i <= pattern.length(); i++) column[i] = i * delCost;
+    }
+    
+    // report(позиция последнего символа окна, стоимость) для каждого конца
+    template <typename Report>
+    void feed(std::string_view text, Report report) {
+        const size_t m = pattern.length();
+        // Отрицательному порогу не подходит ни одно окно
+        if (k < 0) {
+            position += text.size();
+            return;
+        }
+        
+        if (unitCost && m > 0 && m <= 64) {
+            feedWord(text, report);
+            return;
+        }
+        if (unitCost) {
+            for (unsigned char c : text) {
+                score += myers.step(c, 0);
+                if (score * replCost <= k) report(position, score * replCost);
+                position++;
+            }
+            return;
+        }
+        
+        for (char c : text) {
+            int64_t diag = column[0];  // dp[i-1][j-1]
+            column[0] = 0;
+            for (size_t i = 1; i <= m; i++) {
+                int64_t left = column[i];  // dp[i][j-1]
+                if (pattern[i-1] == c) {
+                    column[i] = diag;
+                } else {
+                    column[i] = std::min({diag + replCost, left + insCost, column[i-1] + delCost});
+                }
+                diag = left;
+            }
+            if (column[m] <= k) report(position, column[m]);
+            position++;
+        }
+    }
+    
+private:
+    std::string pattern;
+    int64_t replCost, insCost, delCost, k;
+    bool unitCost;
+    MyersColumn myers;
+    // Образец не длиннее 64 символов: столбец - одно слово в регистрах,
+    // таблица совпадений прямо по байту
+    struct WordColumn {
+        uint64_t Pv = ~uint64_t(0), Mv = 0;
+        int64_t score;
+        
+        // Над образцом dp[0][j] = 0: в столбец ничего не вдвигается
+        void step(uint64_t Eq, int lastBit) {
+            uint64_t Xv = Eq | Mv;
+            uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+            uint64_t Ph = Mv | ~(Xh | Pv);
+            uint64_t Mh = Pv & Xh;
+            score += (int64_t)((Ph >> lastBit) & 1) - (int64_t)((Mh >> lastBit) & 1);
+            Ph <<= 1;
+            Mh <<= 1;
+            Pv = Mh | ~(Xv | Ph);
+            Mv = Ph & Xv;
+        }
+    };
+    
+    // Большой кусок текста (файл через --mmap) делится между потоками. Окно
+    // стоимостью не больше k короче m + k символов, поэтому часть, начатая с
+    // чистого столбца за m + k символов до своего начала, даёт те же ответы,
+    // что и непрерывный проход
+    static constexpr size_t MIN_SEARCH_SEGMENT = 1 << 20;
+    std::array<uint64_t, 256> wordEq{};
+    WordColumn word;
+    
+    template <typename Report>
+    void feedWord(std::string_view text, Report& report) {
+        if (wordEq == std::array<uint64_t, 256>{}) {
+            for (size_t i = 0; i < pattern.length(); i++) wordEq[(unsigned char)pattern[i]] |= uint64_t(1) << i;
+            word.score = pattern.length();
+        }
+        const int lastBit = pattern.length() - 1;
+        // Порог в единицах стоимости (k >= 0); при нулевой стоимости подходит любое окно
+        const int64_t limit = replCost > 0 ? k / replCost : INT64_MAX;
+        
+        auto run = [&](WordColumn& column, size_t from, size_t to, auto&& found) {
+            for (size_t j = from; j < to; j++) {
+                column.step(wordEq[(unsigned char)text[j]], lastBit);
+                if (column.score <= limit) found(position + j, column.score * replCost);
+            }
+        };
+        
+        const size_t n = text.size();
+        const size_t overlap = pattern.length() + std::min<int64_t>(limit, n);
+        const size_t parts = std::min<size_t>(std::thread::hardware_concurrency(), n / std::max(MIN_SEARCH_SEGMENT, 2 * overlap));
+        if (parts <= 1) {
+            run(word, 0, n, report);
+            position += n;
+            return;
+        }
+        
+        // Часть 0 продолжает текущий столбец, остальные разгоняются на
+        // перекрытии без ответов; ответы частей копятся и выдаются по порядку
+        const size_t segment = n / parts;
+        std::vector<WordColumn> columns(parts);
+        std::vector<std::vector<std::pair<uint64_t, int64_t>>> found(parts);
+        std::vector<std::thread> pool;
+        for (size_t part = 0; part < parts; part++) {
+            pool.emplace_back([&, part] {
+                WordColumn& column = columns[part];
+                const size_t from = part * segment, to = part + 1 == parts ? n : from + segment;
+                if (part == 0) {
+                    column = word;
+                } else {
+                    column.score = pattern.length();
+                    run(column, from - overlap, from, [](uint64_t, int64_t) {});
+                }
+                run(column, from, to, [&](uint64_t at, int64_t cost) { found[part].push_back({at, cost}); });
+            });
+        }
+        for (auto& thread : pool) thread.join();
+        
+        for (const auto& matches : found) {
+            for (const auto& [at, cost] : matches) report(at, cost);
+        }
+        word = columns.back();
+        position += n;
+    }
+    
+    int64_t score;
+    std::vector<int64_t> column;
+    uint64_t position = 0;
+};
+
+// Проверка, что стоимость преобразования A в B не больше k. Считается только
+// полоса диагоналей, достижимых со стоимостью не больше k (Укконен): клетка
+// (i, j) требует хотя бы j - i вставок или i - j удалений. Стоимость вдоль
+// пути не убывает, поэтому если все клетки строки больше k, ответ
+// отрицательный без дальнейшего счета. Оба довода верны только при
+// неотрицательных стоимостях; с отрицательными считается полный dp.
+bool editDistanceAtMost(std::string_view A, std::string_view B, int64_t k,
+                        int64_t replCost, int64_t insCost, int64_t delCost) {
+    if (std::min({replCost, insCost, delCost}) < 0) {
+        return minEditDistance(A, B, replCost, insCost, delCost) <= k;
+    }
+    if (k < 0) return false;
+    if (A.length() < B.length()) {
+        return editDistanceAtMost(B, A, k, replCost, delCost, insCost);
+    }
+
+    const size_t m = A.length();
+    const size_t n = B.length();
+    
+    // Нужно хотя бы m - n удалений
+    if (delCost > 0 && m - n > (size_t)(k / delCost)) return false;
+    
+    // Значение вне полосы; запас от переполнения при прибавлении стоимостей
+    const int64_t UNREACHABLE = INT64_MAX / 2;
+    // Полоса: -below <= j - i <= above
+    const size_t above = insCost > 0 ? std::min<size_t>(n, k / insCost) : n;
+    const size_t below = delCost > 0 ? std::min<size_t>(m, k / delCost) : m;
+    
+    std::vector<int64_t> row(n + 1, UNREACHABLE);
+    for (size_t j = 0; j <= above; j++) {
+        row[j] = j * insCost;
+    }
+    
+    for (size_t i = 1; i <= m; i++) {
+        const size_t lo = i > below ? i - below : 0;
+        const size_t hi = std::min(n, i + above);
+        // Клетка hi в предыдущей строке была вне полосы
+        if (hi == i + above) row[hi] = UNREACHABLE;
+        
+        int64_t diag, left, rowMin;
+        size_t j = lo;
+        if (lo == 0) {
+            diag = row[0];
+            row[0] = i * delCost;
+            left = rowMin = row[0];
+            j = 1;
+        } else {
+            diag = row[lo - 1];
+            left = rowMin = UNREACHABLE;
+        }
+        
+        for (; j <= hi; j++) {
+            int64_t up = row[j];
+            int64_t value;
+            if (A[i-1] == B[j-1]) {
+                value = diag;
+            } else {
+                value = std::min({diag + replCost, left + insCost, up + delCost, UNREACHABLE});
+            }
+            row[j] = left = value;
+            rowMin = std::min(rowMin, value);
+            diag = up;
+        }
+        
+        if (rowMin > k) return false;
+    }
+    
+    return row[n] <= k;
+}
+
+// Пакетный режим для множества коротких пар: независимые пары в 16-битных
+// знаковых полосах одного вектора (знаковый минимум есть уже в SSE2), клетка
+// (i, j) всех пар считается одной векторной операцией. Ширина вектора -
+// регистр цели: 16 полос с AVX2, иначе 8. Пары группы дополняются до общих
+// размеров, ответ каждой пары снимается в её клетке (m, n): клетки внутри
+// прямоугольника пары не зависят от дополнения.
+typedef int16_t BatchLanes __attribute__((vector_size(VECTOR_BYTES)));
+const size_t BATCH_LANES = sizeof(BatchLanes) / sizeof(int16_t);
+const size_t MAX_BATCH_LENGTH = 64;
+
+using StringPair = std::pair<std::string, std::string>;
+
+void minEditDistanceGroup(const std::vector<StringPair>& pairs, const size_t* group, size_t count,
+                          int16_t replCost, int16_t insCost, int16_t delCost, int64_t* results) {
+    size_t mMax = 0, nMax = 0;
+    size_t mLane[BATCH_LANES] = {}, nLane[BATCH_LANES] = {};
+    for (size_t l = 0; l < count; l++) {
+        mLane[l] = pairs[group[l]].first.length();
+        nLane[l] = pairs[group[l]].second.length();
+        mMax = std::max(mMax, mLane[l]);
+        nMax = std::max(nMax, nLane[l]);
+    }
+    
+    // Символы пар по полосам; дополнение нулями на ответ не влияет
+    std::vector<BatchLanes> a(mMax), b(nMax);
+    for (size_t l = 0; l < count; l++) {
+        for (size_t i = 0; i < mLane[l]; i++) a[i][l] = (unsigned char)pairs[group[l]].first[i];
+        for (size_t j = 0; j < nLane[l]; j++) b[j][l] = (unsigned char)pairs[group[l]].second[j];
+    }
+    
+    std::vector<BatchLanes> row(nMax + 1);
+    for (size_t j = 0; j <= nMax; j++) row[j] = (BatchLanes){} + (int16_t)(j * insCost);
+    for (size_t l = 0; l < count; l++) {
+        if (mLane[l] == 0) results[group[l]] = row[nLane[l]][l];
+    }
+    
+    const BatchLanes repl = (BatchLanes){} + replCost;
+    const BatchLanes ins = (BatchLanes){} + insCost;
+    const BatchLanes del = (BatchLanes){} + delCost;
+    
+    for (size_t i = 1; i <= mMax; i++) {
+        BatchLanes diag = row[0];
+        row[0] = (BatchLanes){} + (int16_t)(i * delCost);
+        const BatchLanes ai = a[i-1];
+        
+        for (size_t j = 1; j <= nMax; j++) {
+            BatchLanes up = row[j];
+            BatchLanes replOp = diag + repl, insOp = row[j-1] + ins, delOp = up + del;
+            BatchLanes best = replOp < insOp ? replOp : insOp;
+            best = best < delOp ? best : delOp;
+            // При совпадении символов - только диагональ, как в minEditDistance
+            row[j] = ai == b[j-1] ? diag : best;
+            diag = up;
+        }
+        
+        for (size_t l = 0; l < count; l++) {
+            if (mLane[l] == i) results[group[l]] = row[nLane[l]][l];
+        }
+    }
+}
+
+// Стоимости всех пар. В полосы попадают пары не длиннее MAX_BATCH_LENGTH,
+// если (2 * MAX_BATCH_LENGTH + 1) * max(стоимость) помещается в int16_t:
+// клетка (i, j), в том числе дополненная, не дороже пути из i удалений и
+// j вставок, и ещё одна операция добавляется к ней до выбора минимума.
+// Остальные пары считаются по одной
+std::vector<int64_t> minEditDistanceBatch(const std::vector<StringPair>& pairs,
+                                          int64_t replCost, int64_t insCost, int64_t delCost, unsigned threads) {
+    std::vector<int64_t> results(pairs.size());
+    const int64_t maxCost = std::max({replCost, insCost, delCost});
+    const bool lanesFit = std::min({replCost, insCost, delCost}) >= 0 &&
+                          maxCost <= INT16_MAX / (int64_t)(2 * MAX_BATCH_LENGTH + 1);
+    
+    std::vector<size_t> laned, single;
+    for (size_t p = 0; p < pairs.size(); p++) {
+        const size_t length = std::max(pairs[p].first.length(), pairs[p].second.length());
+        (lanesFit && length <= MAX_BATCH_LENGTH ? laned : single).push_back(p);
+    }
+    // Пары близких длин в одной группе меньше дополняются
+    std::sort(laned.begin(), laned.end(), [&](size_t x, size_t y) {
+        return std::make_pair(pairs[x].first.length(), pairs[x].second.length()) <
+               std::make_pair(pairs[y].first.length(), pairs[y].second.length());
+    });
+    
+    const size_t groups = (laned.size() + BATCH_LANES - 1) / BATCH_LANES;
+    threads = std::max(1u, threads);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            for (size_t g = t; g < groups; g += threads) {
+                size_t first = g * BATCH_LANES;
+                minEditDistanceGroup(pairs, &laned[first], std::min(BATCH_LANES, laned.size() - first),
+                                     replCost, insCost, delCost, results.data());
+            }
+            for (size_t k = t; k < single.size(); k += threads) {
+                const StringPair& pair = pairs[single[k]];
+                results[single[k]] = minEditDistance(pair.first, pair.second, replCost, insCost, delCost);
+            }
+        });
+    }
+    for (auto& thread : pool) thread.join();
+    
+    return results;
+}
+
+int main(int argc, char* argv[]) {
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(nullptr);
     
@@ -50,10 +582,84 @@ int main() {
     
     // Ввод данных
     std::cin >> replCost >> insCost >> delCost;
-    std::cin >> A >> B;
+    
+    // "--batch" - пары A B до конца ввода, по стоимости на строку
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        std::vector<StringPair> pairs;
+        while (std::cin >> A >> B) pairs.push_back({A, B});
+        for (int64_t result : minEditDistanceBatch(pairs, replCost, insCost, delCost,
+                                                   std::thread::hardware_concurrency())) {
+            std::cout << result << "\n";
+        }
+        return 0;
+    }
+    
+    // "--mmap файлA файлB" - строки A и B читаются из файлов отображением в
+    // память, следующие аргументы задают режим как обычно
+    MappedFile fileA, fileB;
+    std::string_view a, b;
+    int mode = 1;
+    if (argc > 3 && std::string(argv[1]) == "--mmap") {
+        if (!fileA.open(argv[2]) || !fileB.open(argv[3])) {
+            std::cerr << "Не удалось открыть " << argv[2] << " или " << argv[3] << std::endl;
+            return 1;
+        }
+        a = fileA.sequence();
+        b = fileB.sequence();
+        mode = 4;
+    } else {
+        std::cin >> A;
+        // При поиске текстом служит остаток ввода, он читается ниже кусками
+        if (!(argc > 2 && std::string(argv[1]) == "--search")) std::cin >> B;
+        a = A;
+        b = B;
+    }
+    
+    // "--search k" - все окна текста B со стоимостью не больше k: позиция
+    // последнего символа окна и стоимость. Без --mmap текстом служит весь
+    // остаток ввода после строки A
+    if (argc > mode + 1 && std::string(argv[mode]) == "--search") {
+        int64_t k = std::stoll(argv[mode + 1]);
+        if (k < 0) {
+            std::cerr << "Порог k должен быть неотрицательным" << std::endl;
+            return 1;
+        }
+        ApproximateSearch search(a, replCost, insCost, delCost, k);
+        auto report = [](uint64_t position, int64_t cost) {
+            std::cout << position << " " << cost << "\n";
+        };
+        if (mode > 1) {
+            search.feed(b, report);
+        } else {
+            // Переводы строки в конце ввода не входят в текст, как и в
+            // MappedFile::sequence(): хвост куска из \n и \r придерживается,
+            // пока за ним не придут другие символы
+            std::cin.get();
+            std::vector<char> buffer(1 << 16);
+            std::string held;
+            while (std::cin.read(buffer.data(), buffer.size()) || std::cin.gcount() > 0) {
+                std::string_view chunk(buffer.data(), std::cin.gcount());
+                size_t keep = chunk.find_last_not_of("\r\n") + 1;
+                if (keep > 0) {
+                    search.feed(held, report);
+                    held.clear();
+                }
+                search.feed(chunk.substr(0, keep), report);
+                held.append(chunk.substr(keep));
+            }
+        }
+        return 0;
+    }
+    
+    // "--at-most k" - только проверка, что расстояние не больше k
+    if (argc > mode + 1 && std::string(argv[mode]) == "--at-most") {
+        int64_t k = std::stoll(argv[mode + 1]);
+        std::cout << (editDistanceAtMost(a, b, k, replCost, insCost, delCost) ? "YES" : "NO") << std::endl;
+        return 0;
+    }
     
     // Вывод результата
-    std::cout << minEditDistance(A, B, replCost, insCost, delCost) << std::endl;
+    std::cout << minEditDistance(a, b, replCost, insCost, delCost) << std::endl;
     
     return 0;
 } 
\ No newline at end of file
@@ -3,6 +3,29 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include "cell_type.h"
+
+bool DEBUG = true; // Пошаговая трассировка матрицы DP; ключ --no-trace выключает
+
+// Полная таблица стоимостей: замена любого символа на любой, вставка и
+// удаление каждого символа отдельно
+struct CostTable {
+    std::array<std::array<int64_t, 256>, 256> repl;
+    std::array<int64_t, 256> ins;
+    std::array<int64_t, 256> del;
+    
+    CostTable(int64_t replCost, int64_t insCost, int64_t delCost) {
+        for (int a = 0; a < 256; a++) {
+            repl[a].fill(replCost);
+            repl[a][a] = 0;
+        }
+        ins.fill(insCost);
+        del.fill(delCost);
+    }
+};
 
 void printDP(const std::vector<std::vector<int64_t>>& dp, const std::string& A, const std::string& B) {
     std::cout << "\nТекущая матрица DP:\n";
@@ -23,10 +46,10 @@ void printDP(const std::vector<std::vector<int64_t>>& dp, const std::string& A,
     std::cout << "\n";
 }
 
-int64_t minEditDistance(const std::string& A, const std::string& B,
-                       int64_t replCost, int64_t insCost, int64_t delCost,
-                       char specialRepl, int64_t specialReplCost,
-                       char specialDel, int64_t specialDelCost) {
+// Стоимости берутся из таблицы; об особых символах сообщается, как и раньше,
+// по символу цели замены и удаляемому символу
+int64_t minEditDistanceTraced(const std::string& A, const std::string& B, const CostTable& costs,
+                              char specialRepl, char specialDel) {
     const size_t m = A.length();
     const size_t n = B.length();
     
@@ -36,7 +59,7 @@ int64_t minEditDistance(const std::string& A, const std::string& B,
     for (size_t i = 0; i <= m; i++) {
         dp[i][0] = 0;
         for (size_t k = 0; k < i; k++) {
-            int64_t cost = (A[k] == specialDel) ? specialDelCost : delCost;
+            int64_t cost = costs.del[(unsigned char)A[k]];
             dp[i][0] += cost;
             if (i > 0) {
                 std::cout << "Удаление " << A[k] << " стоит " << cost << "\n";
@@ -46,9 +69,9 @@ int64_t minEditDistance(const std::string& A, const std::string& B,
     
     std::cout << "\nИнициализация первой строки (вставки):\n";
     for (size_t j = 0; j <= n; j++) {
-        dp[0][j] = j * insCost;
+        dp[0][j] = j > 0 ? dp[0][j-1] + costs.ins[(unsigned char)B[j-1]] : 0;
         if (j > 0) {
-            std::cout << "Вставка " << B[j-1] << " стоит " << insCost << "\n";
+            std::cout << "Вставка " << B[j-1] << " стоит " << costs.ins[(unsigned char)B[j-1]] << "\n";
         }
     }
     
@@ -63,25 +86,24 @@ int64_t minEditDistance(const std::string& A, const std::string& B,
                 dp[i][j] = dp[i-1][j-1];
                 std::cout << "Символы совпадают, стоимость 0\n";
             } else {
-                int64_t replaceCost = replCost;
+                int64_t replaceCost = costs.repl[(unsigned char)A[i-1]][(unsigned char)B[j-1]];
                 if (B[j-1] == specialRepl) {
-                    replaceCost = specialReplCost;
-                    std::cout << "Особая замена на " << specialRepl << " стоит " << specialReplCost << "\n";
+                    std::cout << "Особая замена на " << specialRepl << " стоит " << replaceCost << "\n";
                 }
                 
-                int64_t deleteCost = delCost;
+                int64_t deleteCost = costs.del[(unsigned char)A[i-1]];
                 if (A[i-1] == specialDel) {
-                    deleteCost = specialDelCost;
-                    std::cout << "Особое удаление " << specialDel << " стоит " << specialDelCost << "\n";
+                    std::cout << "Особое удаление " << specialDel << " стоит " << deleteCost << "\n";
                 }
                 
+                int64_t insertCost = costs.ins[(unsigned char)B[j-1]];
                 int64_t replOp = dp[i-1][j-1] + replaceCost;
-                int64_t insOp = dp[i][j-1] + insCost;
+                int64_t insOp = dp[i][j-1] + insertCost;
                 int64_t delOp = dp[i-1][j] + deleteCost;
                 
                 std::cout << "Варианты:\n";
                 std::cout << "1. Замена: " << dp[i-1][j-1] << " + " << replaceCost << " = " << replOp << "\n";
-                std::cout << "2. Вставка: " << dp[i][j-1] << " + " << insCost << " = " << insOp << "\n";
+                std::cout << "2. Вставка: " << dp[i][j-1] << " + " << insertCost << " = " << insOp << "\n";
                 std::cout << "3. Удаление: " << dp[i-1][j] << " + " << deleteCost << " = " << delOp << "\n";
                 
                 dp[i][j] = std::min({replOp, insOp, delOp});
@@ -95,7 +117,108 @@ int64_t minEditDistance(const std::string& A, const std::string& B,
     return dp[m][n];
 }
 
-int main() {
+// Профили различных символов A хранятся все сразу, пока занимают не больше
+// стольких байт; иначе профиль строится заново для каждой строки dp
+const size_t MAX_PROFILE_BYTES = size_t(1) << 26;
+
+// Стоимость по таблице без ветвлений в клетке. Для каждого символа A
+// строится профиль по B: стоимости замены и блок вставки, после чего замена
+// и удаление считаются векторным проходом по строке, а вставка - вторым
+// последовательным проходом.
+//
+// Профили σ различных символов A занимают 2σ(n + 1) клеток и строятся по
+// одному разу, если помещаются в MAX_PROFILE_BYTES. Для длинной B над
+// большим алфавитом (1M символов и σ = 256 - около 2 ГБ в int32_t) профиль
+// перестраивается в одном буфере при смене символа A, и память остаётся O(n).
+//
+// Совпадающие символы, как и в пошаговой версии, переходят только по
+// диагонали: удаление и вставка в такой клетке блокируются добавкой
+// max(Cell) / 4. Клетки меньше max(Cell) / 4, поэтому сумма не переполняется,
+// а узкий тип Cell умещает в векторе больше клеток
+template <typename Cell>
+int64_t minEditDistanceCells(const std::string& A, const std::string& B, const CostTable& costs) {
+    const size_t m = A.length();
+    const size_t n = B.length();
+    const Cell matchBlock = std::numeric_limits<Cell>::max() / 4;
+    
+    std::vector<Cell> insB(n + 1, 0);
+    for (size_t j = 1; j <= n; j++) insB[j] = costs.ins[(unsigned char)B[j-1]];
+    
+    std::array<bool, 256> inA{};
+    size_t symbols = 0;
+    for (unsigned char a : A) {
+        if (!inA[a]) symbols++;
+        inA[a] = true;
+    }
+    const bool cacheProfiles = symbols * 2 * (n + 1) * sizeof(Cell) <= MAX_PROFILE_BYTES;
+    
+    // profiled[slot] - символ, профиль которого сейчас лежит в ячейке slot
+    std::array<std::vector<Cell>, 256> replProfile, blockProfile;
+    std::array<int, 256> profiled;
+    profiled.fill(-1);
+    
+    std::vector<Cell> row(n + 1, 0), replDel(n + 1, 0);
+    for (size_t j = 1; j <= n; j++) row[j] = row[j-1] + insB[j];
+    
+    for (size_t i = 1; i <= m; i++) {
+        const unsigned char a = A[i-1];
+        const Cell delCost = costs.del[a];
+        
+        const size_t slot = cacheProfiles ? a : 0;
+        if (profiled[slot] != a) {
+            replProfile[slot].resize(n + 1);
+            blockProfile[slot].resize(n + 1);
+            for (size_t j = 1; j <= n; j++) {
+                replProfile[slot][j] = costs.repl[a][(unsigned char)B[j-1]];
+                blockProfile[slot][j] = (unsigned char)B[j-1] == a ? matchBlock : 0;
+            }
+            profiled[slot] = a;
+        }
+        const Cell* repl = replProfile[slot].data();
+        const Cell* block = blockProfile[slot].data();
+        
+        // Для совпадения block != 0 и удаление отбрасывается вместе со вставкой
+        const Cell* __restrict prev = row.data();
+        Cell* __restrict out = replDel.data();
+        for (size_t j = 1; j <= n; j++) {
+            Cell replOp = prev[j-1] + repl[j];
+            Cell delOp = prev[j] + delCost + block[j];
+            out[j] = replOp < delOp ? replOp : delOp;
+        }
+        row[0] += delCost;
+        for (size_t j = 1; j <= n; j++) {
+            Cell insOp = row[j-1] + insB[j] + block[j];
+            row[j] = replDel[j] < insOp ? replDel[j] : insOp;
+        }
+    }
+    
+    return row[n];
+}
+
+// Клетка таблицы не больше max(m, n) * max(стоимость); с запасом на блок
+// совпадения оценка умножается на 4. При отрицательных стоимостях
+// считается в int64_t
+int64_t minEditDistance(const std::string& A, const std::string& B, const CostTable& costs) {
+    int64_t minCost = std::min(*std::min_element(costs.ins.begin(), costs.ins.end()),
+                               *std::min_element(costs.del.begin(), costs.del.end()));
+    int64_t maxCost = std::max(*std::max_element(costs.ins.begin(), costs.ins.end()),
+                               *std::max_element(costs.del.begin(), costs.del.end()));
+    for (const auto& row : costs.repl) {
+        minCost = std::min(minCost, *std::min_element(row.begin(), row.end()));
+        maxCost = std::max(maxCost, *std::max_element(row.begin(), row.end()));
+    }
+    
+    const int64_t length = std::max<int64_t>({(int64_t)A.length(), (int64_t)B.length(), 1});
+    int64_t bound = -1;
+    if (minCost >= 0 && maxCost <= INT64_MAX / 4 / length) bound = 4 * length * maxCost;
+    
+    return dispatchCellType(bound, [&](auto cell) {
+        return minEditDistanceCells<decltype(cell)>(A, B, costs);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--no-trace") DEBUG = false;
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(nullptr);
     
@@ -120,9 +243,36 @@ int main() {
     std::cout << "Специальный символ замены: " << specialRepl << " (стоимость: " << specialReplCost << ")\n";
     std::cout << "Специальный символ удаления: " << specialDel << " (стоимость: " << specialDelCost << ")\n\n";
     
-    int64_t result = minEditDistance(A, B, replCost, insCost, delCost,
-                                   specialRepl, specialReplCost,
-                                   specialDel, specialDelCost);
+    CostTable costs(replCost, insCost, delCost);
+    for (int a = 0; a < 256; a++) {
+        if (a != (unsigned char)specialRepl) costs.repl[a][(unsigned char)specialRepl] = specialReplCost;
+    }
+    costs.del[(unsigned char)specialDel] = specialDelCost;
+    
+    // Дополнительные строки уточняют таблицу:
+    // R a b c - замена a на b, I a c - вставка a, D a c - удаление a.
+    // Совпадающие символы всегда переходят по диагонали бесплатно, поэтому
+    // замена символа на себя не задается
+    char op, from, to;
+    int64_t cost;
+    while (std::cin >> op) {
+        if (op == 'R' && std::cin >> from >> to >> cost) {
+            if (from == to) {
+                std::cerr << "Замена символа " << from << " на себя не задается" << std::endl;
+                return 1;
+            }
+            costs.repl[(unsigned char)from][(unsigned char)to] = cost;
+        } else if (op == 'I' && std::cin >> from >> cost) {
+            costs.ins[(unsigned char)from] = cost;
+        } else if (op == 'D' && std::cin >> from >> cost) {
+            costs.del[(unsigned char)from] = cost;
+        } else {
+            break;
+        }
+    }
+    
+    int64_t result = DEBUG ? minEditDistanceTraced(A, B, costs, specialRepl, specialDel)
+                           : minEditDistance(A, B, costs);
     
     std::cout << "\nМинимальная стоимость: " << result << std::endl;
     
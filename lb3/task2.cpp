@@ -2,9 +2,20 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include <unordered_map>
+#include <string_view>
+#include "mapped_file.h"
 
-std::pair<int64_t, std::string> getEditSequence(const std::string& A, const std::string& B, 
-                                               int64_t replCost, int64_t insCost, int64_t delCost) {
+// Таблицы dp и operations занимают 9 байт на клетку; для больших входов
+// getEditSequence переходит на алгоритм Хиршберга с линейной памятью
+const size_t MAX_TABLE_CELLS = size_t(1) << 24;
+
+std::pair<int64_t, std::string> getEditSequenceTable(std::string_view A, std::string_view B,
+                                                    int64_t replCost, int64_t insCost, int64_t delCost) {
     const size_t m = A.length();
     const size_t n = B.length();
     
@@ -49,46 +60,378 @@ std::pair<int64_t, std::string> getEditSequence(const std::string& A, const std:
         }
     }
     
-    // Восстановление последовательности операций
+    // Восстановление последовательности операций с конца; строка
+    // разворачивается один раз в конце вместо вставок в начало
     std::string sequence;
+    sequence.reserve(m + n);
     size_t i = m, j = n;
     
     while (i > 0 || j > 0) {
         if (i > 0 && j > 0 && (operations[i][j] == 'M' || operations[i][j] == 'R')) {
-            sequence = operations[i][j] + sequence;
+            sequence += operations[i][j];
             i--; j--;
         }
         else if (i > 0 && operations[i][j] == 'D') {
-            sequence = 'D' + sequence;
+            sequence += 'D';
             i--;
         }
         else if (j > 0) {
-            sequence = 'I' + sequence;
+            sequence += 'I';
             j--;
         }
     }
+    std::reverse(sequence.begin(), sequence.end());
     
     return {dp[m][n], sequence};
 }
 
-int main() {
+// Алгоритм Хиршберга: строка A делится пополам, прямой проход по верхней
+// половине и обратный по нижней дают столбец, через который проходит
+// оптимальный путь, после чего половины решаются независимо (и параллельно).
+// Операция, начинающаяся в клетке (i, j), записывается в позицию i + j общего
+// буфера длины m + n; после диагонального шага позиция остается пустой.
+// Поэтому половины пишут в непересекающиеся части буфера, а итоговая
+// строка получается одним проходом, пропускающим пустые позиции.
+struct HirschbergAligner {
+    std::string_view A;
+    std::string_view B;
+    int64_t replCost, insCost, delCost;
+    std::vector<char>& script;
+
+    // Подзадачи не больше этого размера решаются полной таблицей
+    static const size_t BASE_CELLS = 1 << 16;
+    // Меньшие подзадачи не выносятся в отдельный поток
+    static const size_t PARALLEL_CELLS = 1 << 22;
+
+    // row[j] - стоимость преобразования A[i0..i1) в B[j0..j0+j)
+    void forwardRow(size_t i0, size_t i1, size_t j0, size_t j1, std::vector<int64_t>& row) const {
+        const size_t w = j1 - j0;
+        row.assign(w + 1, 0);
+        for (size_t j = 0; j <= w; j++) row[j] = j * insCost;
+        
+        for (size_t i = i0; i < i1; i++) {
+            int64_t diag = row[0];
+            row[0] = (i + 1 - i0) * delCost;
+            for (size_t j = 1; j <= w; j++) {
+                int64_t up = row[j];
+                if (A[i] == B[j0 + j - 1]) row[j] = diag;
+                else row[j] = std::min({diag + replCost, row[j-1] + insCost, up + delCost});
+                diag = up;
+            }
+        }
+    }
+
+    // row[j] - стоимость преобразования A[i0..i1) в B[j0+j..j1)
+    void backwardRow(size_t i0, size_t i1, size_t j0, size_t j1, std::vector<int64_t>& row) const {
+        const size_t w = j1 - j0;
+        row.assign(w + 1, 0);
+        for (size_t j = 0; j <= w; j++) row[j] = (w - j) * insCost;
+        
+        for (size_t i = i1; i-- > i0;) {
+            int64_t diag = row[w];
+            row[w] = (i1 - i) * delCost;
+            for (size_t j = w; j-- > 0;) {
+                int64_t down = row[j];
+                if (A[i] == B[j0 + j]) row[j] = diag;
+                else row[j] = std::min({diag + replCost, row[j+1] + insCost, down + delCost});
+                diag = down;
+            }
+        }
+    }
+
+    // Небольшая подзадача: та же таблица, что в getEditSequenceTable
+    void solveTable(size_t i0, size_t i1, size_t j0, size_t j1) {
+        std::string sequence = getEditSequenceTable(A.substr(i0, i1 - i0), B.substr(j0, j1 - j0),
+                                                    replCost, insCost, delCost).second;
+        size_t i = i0, j = j0;
+        for (char op : sequence) {
+            script[i + j] = op;
+            if (op != 'I') i++;
+            if (op != 'D') j++;
+        }
+    }
+
+    void solve(size_t i0, size_t i1, size_t j0, size_t j1, int parallelDepth) {
+        const size_t cells = (i1 - i0 + 1) * (j1 - j0 + 1);
+        if (i1 - i0 <= 1 || cells <= BASE_CELLS) {
+            solveTable(i0, i1, j0, j1);
+            return;
+        }
+
+        const size_t mid = (i0 + i1) / 2;
+        size_t split = splitColumn(i0, mid, i1, j0, j1, parallelDepth > 0 && cells > PARALLEL_CELLS).second;
+
+        if (parallelDepth > 0 && cells > PARALLEL_CELLS) {
+            auto upper = std::async(std::launch::async, [&] { solve(i0, mid, j0, split, parallelDepth - 1); });
+            solve(mid, i1, split, j1, parallelDepth - 1);
+            upper.get();
+        } else {
+            solve(i0, mid, j0, split, 0);
+            solve(mid, i1, split, j1, 0);
+        }
+    }
+
+    // Стоимость и столбец, в котором оптимальный путь пересекает строку mid
+    std::pair<int64_t, size_t> splitColumn(size_t i0, size_t mid, size_t i1, size_t j0, size_t j1, bool parallel) const {
+        std::vector<int64_t> forward, backward;
+        if (parallel) {
+            auto upper = std::async(std::launch::async, [&] { forwardRow(i0, mid, j0, j1, forward); });
+            backwardRow(mid, i1, j0, j1, backward);
+            upper.get();
+        } else {
+            forwardRow(i0, mid, j0, j1, forward);
+            backwardRow(mid, i1, j0, j1, backward);
+        }
+
+        size_t best = 0;
+        for (size_t j = 1; j < forward.size(); j++) {
+            if (forward[j] + backward[j] < forward[best] + backward[best]) best = j;
+        }
+        return {forward[best] + backward[best], j0 + best};
+    }
+};
+
+std::pair<int64_t, std::string> getEditSequenceHirschberg(std::string_view A, std::string_view B,
+                                                         int64_t replCost, int64_t insCost, int64_t delCost) {
+    const size_t m = A.length();
+    const size_t n = B.length();
+    
+    // Глубина рекурсии, до которой половины решаются в отдельных потоках
+    int parallelDepth = 0;
+    while ((1u << parallelDepth) < std::max(1u, std::thread::hardware_concurrency())) parallelDepth++;
+    
+    std::vector<char> script(m + n, 0);
+    HirschbergAligner aligner{A, B, replCost, insCost, delCost, script};
+    
+    aligner.solve(0, m, 0, n, parallelDepth);
+    
+    // Стоимость складывается по операциям найденного пути, а не отдельным
+    // разрезом верхнего уровня: он совпал бы с первым разрезом в solve
+    std::string sequence;
+    sequence.reserve(m + n);
+    int64_t cost = 0;
+    for (char op : script) {
+        if (!op) continue;
+        sequence += op;
+        if (op == 'R') cost += replCost;
+        else if (op == 'I') cost += insCost;
+        else if (op == 'D') cost += delCost;
+    }
+    return {cost, sequence};
+}
+
+std::pair<int64_t, std::string> getEditSequence(std::string_view A, std::string_view B,
+                                               int64_t replCost, int64_t insCost, int64_t delCost) {
+    if ((A.length() + 1) * (B.length() + 1) <= MAX_TABLE_CELLS) {
+        return getEditSequenceTable(A, B, replCost, insCost, delCost);
+    }
+    return getEditSequenceHirschberg(A, B, replCost, insCost, delCost);
+}
+
+// Разбиение текста на строки или, при tokens, на слова между пробельными
+// символами. Части ссылаются на исходный текст без копирования
+std::vector<std::string_view> splitText(std::string_view text, bool tokens) {
+    std::vector<std::string_view> parts;
+    // В пустом файле нет ни одной строки, а не одна пустая
+    if (text.empty()) return parts;
+    size_t start = 0;
+    for (size_t i = 0; i <= text.length(); i++) {
+        bool boundary = i == text.length() || (tokens ? std::isspace((unsigned char)text[i]) : text[i] == '\n');
+        if (!boundary) continue;
+        if (!tokens || i > start) parts.push_back(text.substr(start, i - start));
+        start = i + 1;
+    }
+    // Перевод строки в конце файла не образует пустую последнюю строку
+    if (!tokens && !parts.empty() && parts.back().empty() && text.back() == '\n') {
+        parts.pop_back();
+    }
+    return parts;
+}
+
+// Разность последовательностей номеров алгоритмом Майерса за O((m + n) D) и
+// линейную память: средняя змейка (участок совпадений на середине
+// кратчайшего пути) ищется встречными проходами по диагоналям, после чего
+// части до и после неё решаются рекурсивно. Операции M, I, D дописываются
+// в script слева направо.
+struct MyersDiff {
+    const std::vector<uint32_t>& A;
+    const std::vector<uint32_t>& B;
+    std::string& script;
+    // Дальние x на диагоналях k прямого и обратного прохода, со смещением
+    std::vector<int64_t> forward, backward;
+
+    struct Snake {
+        int64_t x, y, u, v;
+    };
+
+    // Средняя змейка задачи A[i0..i1) -> B[j0..j1) в координатах задачи;
+    // начала и концы строк уже различаются, поэтому D >= 2
+    Snake middleSnake(int64_t i0, int64_t i1, int64_t j0, int64_t j1) {
+        const int64_t n = i1 - i0, m = j1 - j0;
+        const int64_t delta = n - m;
+        const bool odd = delta & 1;
+        // Диагонали обратного прохода сдвинуты на delta относительно прямого
+        const int64_t offset = (n + m) / 2 + std::abs(delta) + 2;
+        // Каждая диагональ записывается раньше, чем читается, поэтому буферы
+        // только растут и не очищаются между вызовами
+        if (forward.size() < size_t(2 * offset + 1)) {
+            forward.resize(2 * offset + 1);
+            backward.resize(2 * offset + 1);
+        }
+        int64_t* vf = forward.data() + offset;
+        int64_t* vb = backward.data() + offset;
+        vf[1] = 0;
+        vb[delta - 1] = n;
+        
+        for (int64_t d = 0; d <= (n + m + 1) / 2; d++) {
+            for (int64_t k = -d; k <= d; k += 2) {
+                int64_t x = (k == -d || (k != d && vf[k-1] < vf[k+1])) ? vf[k+1] : vf[k-1] + 1;
+                int64_t y = x - k;
+                const int64_t x0 = x, y0 = y;
+                while (x < n && y < m && A[i0 + x] == B[j0 + y]) { x++; y++; }
+                vf[k] = x;
+                if (odd && k >= delta - (d - 1) && k <= delta + (d - 1) && vf[k] >= vb[k]) {
+                    return {x0, y0, x, y};
+                }
+            }
+            for (int64_t k = -d; k <= d; k += 2) {
+                const int64_t kk = k + delta;
+                int64_t x = (k == d || (k != -d && vb[kk-1] < vb[kk+1])) ? vb[kk-1] : vb[kk+1] - 1;
+                int64_t y = x - kk;
+                const int64_t x0 = x, y0 = y;
+                while (x > 0 && y > 0 && A[i0 + x - 1] == B[j0 + y - 1]) { x--; y--; }
+                vb[kk] = x;
+                if (!odd && kk >= -d && kk <= d && vf[kk] >= vb[kk]) {
+                    return {x, y, x0, y0};
+                }
+            }
+        }
+        return {0, 0, 0, 0};
+    }
+
+    void solve(int64_t i0, int64_t i1, int64_t j0, int64_t j1) {
+        // Общие начало и конец - совпадения
+        int64_t prefix = 0, suffix = 0;
+        while (i0 + prefix < i1 && j0 + prefix < j1 && A[i0 + prefix] == B[j0 + prefix]) prefix++;
+        while (i0 + prefix < i1 - suffix && j0 + prefix < j1 - suffix &&
+               A[i1 - suffix - 1] == B[j1 - suffix - 1]) suffix++;
+        script.append(prefix, 'M');
+        i0 += prefix; j0 += prefix;
+        i1 -= suffix; j1 -= suffix;
+        
+        if (i0 == i1) {
+            script.append(j1 - j0, 'I');
+        } else if (j0 == j1) {
+            script.append(i1 - i0, 'D');
+        } else {
+            Snake snake = middleSnake(i0, i1, j0, j1);
+            solve(i0, i0 + snake.x, j0, j0 + snake.y);
+            script.append(snake.u - snake.x, 'M');
+            solve(i0 + snake.u, i1, j0 + snake.v, j1);
+        }
+        script.append(suffix, 'M');
+    }
+};
+
+// Предписание по строкам (или словам): те же операции M, R, I, D, что и у
+// getEditSequence, но над строками целиком. Строки заменяются номерами,
+// одинаковые строки - одинаковыми номерами. Подряд идущие удаления и
+// вставки одного участка сводятся в замены
+std::string getLineEditSequence(std::string_view A, std::string_view B, bool tokens) {
+    std::vector<std::string_view> linesA = splitText(A, tokens), linesB = splitText(B, tokens);
+    std::unordered_map<std::string_view, uint32_t> ids;
+    ids.reserve(linesA.size() + linesB.size());
+    std::vector<uint32_t> idsA, idsB;
+    idsA.reserve(linesA.size());
+    idsB.reserve(linesB.size());
+    for (std::string_view line : linesA) idsA.push_back(ids.emplace(line, ids.size()).first->second);
+    for (std::string_view line : linesB) idsB.push_back(ids.emplace(line, ids.size()).first->second);
+    
+    std::string script;
+    script.reserve(idsA.size() + idsB.size());
+    MyersDiff diff{idsA, idsB, script, {}, {}};
+    diff.solve(0, idsA.size(), 0, idsB.size());
+    
+    std::string sequence;
+    sequence.reserve(script.size());
+    for (size_t i = 0; i < script.size();) {
+        if (script[i] == 'M') {
+            sequence += script[i++];
+            continue;
+        }
+        size_t deleted = 0, inserted = 0;
+        for (; i < script.size() && script[i] != 'M'; i++) {
+            if (script[i] == 'D') deleted++;
+            else inserted++;
+        }
+        size_t replaced = std::min(deleted, inserted);
+        sequence.append(replaced, 'R');
+        sequence.append(deleted - replaced, 'D');
+        sequence.append(inserted - replaced, 'I');
+    }
+    return sequence;
+}
+
+int main(int argc, char* argv[]) {
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(nullptr);
     
+    // "--diff файлA файлB" / "--diff-tokens файлA файлB" - предписание по
+    // строкам или словам файлов, стоимости не нужны
+    if (argc == 4 && (std::string(argv[1]) == "--diff" || std::string(argv[1]) == "--diff-tokens")) {
+        MappedFile fileA, fileB;
+        if (!fileA.open(argv[2]) || !fileB.open(argv[3])) {
+            std::cerr << "Не удалось открыть " << argv[2] << " или " << argv[3] << std::endl;
+            return 1;
+        }
+        std::cout << getLineEditSequence(fileA.bytes(), fileB.bytes(), std::string(argv[1]) == "--diff-tokens") << std::endl;
+        return 0;
+    }
+    
+    // "--hirschberg" - алгоритм Хиршберга независимо от размера входа;
+    // "--mmap файлA файлB" - строки читаются из файлов отображением в память
+    bool forceHirschberg = false;
+    const char* pathA = nullptr;
+    const char* pathB = nullptr;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--hirschberg") {
+            forceHirschberg = true;
+        } else if (arg == "--mmap" && i + 2 < argc) {
+            pathA = argv[++i];
+            pathB = argv[++i];
+        }
+    }
+    
     int64_t replCost, insCost, delCost;
     std::string A, B;
+    MappedFile fileA, fileB;
+    std::string_view a, b;
     
     // Ввод данных
     std::cin >> replCost >> insCost >> delCost;
-    std::cin >> A >> B;
+    if (pathA) {
+        if (!fileA.open(pathA) || !fileB.open(pathB)) {
+            std::cerr << "Не удалось открыть " << pathA << " или " << pathB << std::endl;
+            return 1;
+        }
+        a = fileA.sequence();
+        b = fileB.sequence();
+    } else {
+        std::cin >> A >> B;
+        a = A;
+        b = B;
+    }
     
     // Получение результата
-    auto [cost, sequence] = getEditSequence(A, B, replCost, insCost, delCost);
+    auto [cost, sequence] = forceHirschberg
+        ? getEditSequenceHirschberg(a, b, replCost, insCost, delCost)
+        : getEditSequence(a, b, replCost, insCost, delCost);
     
     // Вывод результата
     std::cout << sequence << std::endl;
-    std::cout << A << std::endl;
-    std::cout << B << std::endl;
+    std::cout << a << std::endl;
+    std::cout << b << std::endl;
     
     return 0;
-} 
\ No newline at end of file
+}
@@ -2,48 +2,473 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <utility>
+#include <cstring>
+#include <thread>
+#include <string_view>
+#include "mapped_file.h"
+#include "myers_column.h"
 
-int64_t levenshteinDistance(const std::string& source, const std::string& target) {
-    const size_t m = source.length();
-    const size_t n = target.length();
+// Расстояние Левенштейна от одного образца до многих слов: таблица образца
+// в MyersColumn строится один раз, для каждого слова столбец сбрасывается.
+// Объект держит рабочие векторы и не делится между потоками.
+class LevenshteinPattern {
+public:
+    explicit LevenshteinPattern(std::string_view pattern) : m(pattern.length()), column(pattern) {}
     
-    // Создаем матрицу dp[i][j], где i и j - длины префиксов строк
-    std::vector<std::vector<int64_t>> dp(m + 1, std::vector<int64_t>(n + 1, 0));
+    int64_t distance(const char* text, size_t n) const {
+        if (m == 0) return n;
+        
+        column.reset();
+        int64_t score = m;
+        // Над образцом dp[0][j] = j: горизонтальное приращение +1
+        for (size_t j = 0; j < n; j++) score += column.step(text[j], 1);
+        return score;
+    }
+    
+private:
+    size_t m;
+    mutable MyersColumn column;
+};
+
+// Образцом берётся более короткая строка: у неё меньше блоков
+int64_t levenshteinDistance(std::string_view source, std::string_view target) {
+    std::string_view pattern = source.length() <= target.length() ? source : target;
+    std::string_view text = source.length() <= target.length() ? target : source;
+    return LevenshteinPattern(pattern).distance(text.data(), text.length());
+}
+
+// Словарь в префиксном дереве для поиска слов, близких к запросу. Обход в
+// глубину ведёт по строке dp на каждый уровень: row[j] - расстояние между
+// префиксом узла и первыми j символами запроса. Общие префиксы слов
+// считаются один раз, а ветви, в которых минимум строки превысил порог,
+// отсекаются: дальше по ветви расстояние только растёт.
+class TrieDictionary {
+public:
+    using Match = std::pair<std::string, int64_t>;
+    
+    TrieDictionary() : nodes(1) {}
+    
+    void insert(const std::string& word) {
+        uint32_t node = 0;
+        for (char c : word) {
+            auto& children = nodes[node].children;
+            auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(c, uint32_t(0)));
+            if (it == children.end() || it->first != c) {
+                it = children.insert(it, {c, (uint32_t)nodes.size()});
+                nodes.emplace_back();
+            }
+            node = it->second;
+        }
+        nodes[node].terminal = true;
+        maxDepth = std::max(maxDepth, word.length());
+    }
+    
+    // Все слова на расстоянии не больше k, по возрастанию расстояния
+    std::vector<Match> withinDistance(const std::string& query, int64_t k) const {
+        std::vector<Match> result;
+        walk(query, k, [&](const std::string& word, int64_t distance) {
+            result.push_back({word, distance});
+        });
+        sortMatches(result);
+        return result;
+    }
+    
+    // count ближайших слов; при равных расстояниях - в лексикографическом
+    // порядке. Один обход с отсечением: пока слов меньше count, порог -
+    // наибольшее возможное расстояние, затем - на единицу меньше худшего из
+    // набранных. Обход выдаёт слова в лексикографическом порядке, поэтому
+    // слово с тем же расстоянием, что у худшего, его уже не вытесняет
+    std::vector<Match> nearest(const std::string& query, size_t count) const {
+        // Куча по порядку ответа: наверху худшее из набранных слов
+        std::vector<Match> best;
+        if (count == 0) return best;
+        
+        int64_t limit = std::max(query.length(), maxDepth);
+        walk(query, limit, [&](const std::string& word, int64_t distance) {
+            best.push_back({word, distance});
+            std::push_heap(best.begin(), best.end(), matchLess);
+            if (best.size() > count) {
+                std::pop_heap(best.begin(), best.end(), matchLess);
+                best.pop_back();
+            }
+            if (best.size() == count) limit = best.front().second - 1;
+        });
+        sortMatches(best);
+        return best;
+    }
+    
+private:
+    struct Node {
+        std::vector<std::pair<char, uint32_t>> children;
+        bool terminal = false;
+    };
+    
+    std::vector<Node> nodes;
+    size_t maxDepth = 0;
+    
+    static bool matchLess(const Match& a, const Match& b) {
+        return a.second != b.second ? a.second < b.second : a.first < b.first;
+    }
     
-    // Инициализация первой строки и столбца
-    for (size_t i = 0; i <= m; i++) {
-        dp[i][0] = i; // Стоимость удаления i символов
+    static void sortMatches(std::vector<Match>& matches) {
+        std::sort(matches.begin(), matches.end(), matchLess);
     }
-    for (size_t j = 0; j <= n; j++) {
-        dp[0][j] = j; // Стоимость вставки j символов
+    
+    // Обход с порогом limit; visit может уменьшить порог, и дальше ветви
+    // отсекаются по новому. Строки dp всех уровней лежат в одном буфере,
+    // строка уровня d переиспользуется всеми узлами глубины d.
+    template <typename Visit>
+    void walk(const std::string& query, int64_t& limit, Visit visit) const {
+        const size_t m = query.length();
+        std::vector<int64_t> rows((maxDepth + 1) * (m + 1));
+        for (size_t j = 0; j <= m; j++) rows[j] = j;
+        
+        std::string word;
+        if (nodes[0].terminal && (int64_t)m <= limit) visit(word, m);
+        walkChildren(0, query, limit, rows, word, visit);
+    }
+    
+    template <typename Visit>
+    void walkChildren(uint32_t node, const std::string& query, const int64_t& limit,
+                      std::vector<int64_t>& rows, std::string& word, Visit& visit) const {
+        const size_t m = query.length();
+        const size_t depth = word.length();
+        
+        for (const auto& [c, child] : nodes[node].children) {
+            const int64_t* prev = &rows[depth * (m + 1)];
+            int64_t* row = &rows[(depth + 1) * (m + 1)];
+            
+            row[0] = prev[0] + 1;
+            int64_t rowMin = row[0];
+            for (size_t j = 1; j <= m; j++) {
+                int64_t value = prev[j-1] + (query[j-1] != c);
+                value = std::min(value, std::min(prev[j], row[j-1]) + 1);
+                row[j] = value;
+                rowMin = std::min(rowMin, value);
+            }
+            if (rowMin > limit) continue;
+            
+            word.push_back(c);
+            if (nodes[child].terminal && row[m] <= limit) visit(word, row[m]);
+            walkChildren(child, query, limit, rows, word, visit);
+            word.pop_back();
+        }
+    }
+};
+
+
+// BK-дерево: у каждого узла дети разложены по расстоянию d(узел, ребёнок).
+// По неравенству треугольника слово на расстоянии <= k от запроса может
+// лежать только в поддеревьях с d в [d(запрос, узел) - k, d(запрос, узел) + k],
+// остальные поддеревья пропускаются целиком.
+//
+// Дерево хранится плоско, в виде, пригодном для записи в файл и чтения
+// через mmap без разбора: заголовок, массив узлов, массив рёбер (рёбра
+// одного узла подряд и по возрастанию расстояния) и все слова подряд.
+struct BKHeader {
+    char magic[4];
+    uint32_t nodeCount;
+    uint32_t edgeCount;
+    uint32_t textSize;
+};
+
+struct BKNode {
+    uint32_t wordOffset;
+    uint32_t wordLength;
+    uint32_t firstEdge;
+    uint32_t edgeCount;
+};
+
+struct BKEdge {
+    uint32_t distance;
+    uint32_t node;
+};
+
+const char BK_MAGIC[4] = {'B', 'K', 'T', '1'};
+
+// Неизменяемое представление плоского дерева поверх чужой памяти; запросы
+// ничего не изменяют, поэтому их можно выполнять из многих потоков сразу
+class BKTreeView {
+public:
+    using Match = std::pair<std::string, int64_t>;
+    
+    BKTreeView() = default;
+    BKTreeView(const BKNode* nodes, uint32_t nodeCount, const BKEdge* edges, const char* text)
+        : nodes(nodes), nodeCount(nodeCount), edges(edges), text(text) {}
+    
+    // Все слова на расстоянии не больше k, по возрастанию расстояния
+    std::vector<Match> withinDistance(const std::string& query, int64_t k) const {
+        std::vector<Match> result;
+        if (nodeCount == 0) return result;
+        
+        const LevenshteinPattern pattern(query);
+        std::vector<uint32_t> stack = {0};
+        while (!stack.empty()) {
+            const BKNode& node = nodes[stack.back()];
+            stack.pop_back();
+            
+            int64_t distance = pattern.distance(text + node.wordOffset, node.wordLength);
+            if (distance <= k) result.push_back({std::string(text + node.wordOffset, node.wordLength), distance});
+            
+            const BKEdge* first = edges + node.firstEdge;
+            const BKEdge* last = first + node.edgeCount;
+            const int64_t low = std::max<int64_t>(distance - k, 1);
+            const BKEdge* it = std::lower_bound(first, last, low, [](const BKEdge& edge, int64_t d) {
+                return (int64_t)edge.distance < d;
+            });
+            for (; it != last && (int64_t)it->distance <= distance + k; ++it) {
+                stack.push_back(it->node);
+            }
+        }
+        
+        std::sort(result.begin(), result.end(), [](const Match& a, const Match& b) {
+            return a.second != b.second ? a.second < b.second : a.first < b.first;
+        });
+        return result;
+    }
+    
+    uint32_t size() const { return nodeCount; }
+    
+private:
+    const BKNode* nodes = nullptr;
+    uint32_t nodeCount = 0;
+    const BKEdge* edges = nullptr;
+    const char* text = nullptr;
+};
+
+// Построение дерева в памяти и запись в файл
+class BKTree {
+public:
+    void insert(const std::string& word) {
+        if (build.empty()) {
+            build.push_back({word, {}});
+            return;
+        }
+        const LevenshteinPattern pattern(word);
+        size_t node = 0;
+        while (true) {
+            const std::string& other = build[node].word;
+            int64_t distance = pattern.distance(other.data(), other.length());
+            if (distance == 0) return;
+            auto& children = build[node].children;
+            auto it = std::lower_bound(children.begin(), children.end(), std::make_pair((uint32_t)distance, size_t(0)));
+            if (it == children.end() || it->first != distance) {
+                children.insert(it, {(uint32_t)distance, build.size()});
+                build.push_back({word, {}});
+                return;
+            }
+            node = it->second;
+        }
     }
     
-    // Заполняем матрицу
-    for (size_t i = 1; i <= m; i++) {
-        for (size_t j = 1; j <= n; j++) {
-            if (source[i-1] == target[j-1]) {
-                dp[i][j] = dp[i-1][j-1];
-            } else {
-                // Выбираем минимальную операцию:
-                // 1. Замена символа (dp[i-1][j-1] + 1)
-                // 2. Удаление символа из source (dp[i-1][j] + 1)
-                // 3. Вставка символа из target (dp[i][j-1] + 1)
-                dp[i][j] = std::min({
-                    dp[i-1][j-1] + 1, // замена
-                    dp[i-1][j] + 1,   // удаление
-                    dp[i][j-1] + 1    // вставка
-                });
+    // Раскладывает дерево в плоские массивы; вызывается после всех вставок
+    BKTreeView view() {
+        nodes.clear();
+        edges.clear();
+        text.clear();
+        for (const auto& node : build) {
+            nodes.push_back({(uint32_t)text.size(), (uint32_t)node.word.length(),
+                             (uint32_t)edges.size(), (uint32_t)node.children.size()});
+            text += node.word;
+            for (const auto& [distance, child] : node.children) {
+                edges.push_back({distance, (uint32_t)child});
             }
         }
+        return BKTreeView(nodes.data(), nodes.size(), edges.data(), text.data());
+    }
+    
+    // Смещения и счётчики в файле 32-битные: словарь, который в них не
+    // помещается, не записывается
+    bool save(const std::string& path) {
+        size_t textSize = 0, edgeCount = 0;
+        for (const auto& node : build) {
+            textSize += node.word.length();
+            edgeCount += node.children.size();
+        }
+        if (build.size() > UINT32_MAX || edgeCount > UINT32_MAX || textSize > UINT32_MAX) return false;
+        
+        view();
+        std::ofstream output(path, std::ios::binary);
+        BKHeader header;
+        std::memcpy(header.magic, BK_MAGIC, sizeof(header.magic));
+        header.nodeCount = nodes.size();
+        header.edgeCount = edges.size();
+        header.textSize = text.size();
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(BKNode));
+        output.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(BKEdge));
+        output.write(text.data(), text.size());
+        return bool(output);
     }
     
-    return dp[m][n];
+private:
+    struct BuildNode {
+        std::string word;
+        std::vector<std::pair<uint32_t, size_t>> children;
+    };
+    
+    std::vector<BuildNode> build;
+    std::vector<BKNode> nodes;
+    std::vector<BKEdge> edges;
+    std::string text;
+};
+
+// Дерево, отображённое из файла в память только для чтения
+class MappedBKTree {
+public:
+    bool open(const std::string& path) {
+        if (!file.open(path.c_str())) return false;
+        std::string_view bytes = file.bytes();
+        if (bytes.size() < sizeof(BKHeader)) return false;
+        
+        BKHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        const size_t nodesOffset = sizeof(BKHeader);
+        const size_t edgesOffset = nodesOffset + (size_t)header.nodeCount * sizeof(BKNode);
+        const size_t textOffset = edgesOffset + (size_t)header.edgeCount * sizeof(BKEdge);
+        if (std::memcmp(header.magic, BK_MAGIC, sizeof(header.magic)) != 0 ||
+            textOffset + header.textSize != bytes.size()) {
+            return false;
+        }
+        
+        const BKNode* nodes = reinterpret_cast<const BKNode*>(bytes.data() + nodesOffset);
+        const BKEdge* edges = reinterpret_cast<const BKEdge*>(bytes.data() + edgesOffset);
+        if (!valid(header, nodes, edges)) return false;
+        tree = BKTreeView(nodes, header.nodeCount, edges, bytes.data() + textOffset);
+        return true;
+    }
+    
+    const BKTreeView& view() const { return tree; }
+    
+private:
+    MappedFile file;
+    BKTreeView tree;
+    
+    // Запросы читают узлы и рёбра без проверок, поэтому повреждённый файл
+    // отвергается целиком: слова и диапазоны рёбер лежат в своих массивах,
+    // у каждого узла, кроме корня, ровно один родитель с меньшим номером
+    // (запрос не зацикливается), рёбра узла идут по возрастанию расстояния
+    static bool valid(const BKHeader& header, const BKNode* nodes, const BKEdge* edges) {
+        if (header.nodeCount == 0) return header.edgeCount == 0;
+        if (header.edgeCount != header.nodeCount - 1) return false;
+        
+        std::vector<bool> hasParent(header.nodeCount, false);
+        for (uint32_t v = 0; v < header.nodeCount; v++) {
+            const BKNode& node = nodes[v];
+            if ((uint64_t)node.wordOffset + node.wordLength > header.textSize ||
+                (uint64_t)node.firstEdge + node.edgeCount > header.edgeCount) {
+                return false;
+            }
+            for (uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; e++) {
+                const BKEdge& edge = edges[e];
+                if (edge.node <= v || edge.node >= header.nodeCount || hasParent[edge.node] || edge.distance == 0 ||
+                    (e > node.firstEdge && edges[e - 1].distance >= edge.distance)) {
+                    return false;
+                }
+                hasParent[edge.node] = true;
+            }
+        }
+        return true;
+    }
+};
+
+// Ответы на запросы в несколько потоков, порядок ответов совпадает с порядком запросов
+std::vector<std::vector<BKTreeView::Match>> queryParallel(const BKTreeView& tree,
+                                                          const std::vector<std::string>& queries, int64_t k) {
+    std::vector<std::vector<BKTreeView::Match>> results(queries.size());
+    const size_t threads = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), queries.size()));
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            for (size_t i = t; i < queries.size(); i += threads) {
+                results[i] = tree.withinDistance(queries[i], k);
+            }
+        });
+    }
+    for (auto& thread : pool) thread.join();
+    return results;
+}
+
+void printMatches(const std::vector<std::pair<std::string, int64_t>>& matches) {
+    for (size_t i = 0; i < matches.size(); i++) {
+        std::cout << (i ? " " : "") << matches[i].first << ":" << matches[i].second;
+    }
+    std::cout << "\n";
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(nullptr);
     
+    // --within файл k / --nearest файл count: словарь из файла по слову в
+    // строке, запросы со стандартного входа, по строке ответа на запрос
+    if (argc == 4 && (std::string(argv[1]) == "--within" || std::string(argv[1]) == "--nearest")) {
+        std::ifstream input(argv[2]);
+        if (!input) {
+            std::cerr << "Не удалось открыть словарь " << argv[2] << std::endl;
+            return 1;
+        }
+        TrieDictionary dictionary;
+        std::string word;
+        while (std::getline(input, word)) dictionary.insert(word);
+        
+        const bool within = std::string(argv[1]) == "--within";
+        const int64_t limit = std::stoll(argv[3]);
+        std::string query;
+        while (std::getline(std::cin, query)) {
+            printMatches(within ? dictionary.withinDistance(query, limit)
+                                : dictionary.nearest(query, limit));
+        }
+        return 0;
+    }
+    
+    // --bk-build словарь файл: построить BK-дерево и сохранить;
+    // --bk-query файл k: запросы со стандартного входа к отображённому дереву
+    if (argc == 4 && std::string(argv[1]) == "--bk-build") {
+        std::ifstream input(argv[2]);
+        if (!input) {
+            std::cerr << "Не удалось открыть словарь " << argv[2] << std::endl;
+            return 1;
+        }
+        BKTree tree;
+        std::string word;
+        while (std::getline(input, word)) tree.insert(word);
+        if (!tree.save(argv[3])) {
+            std::cerr << "Не удалось записать " << argv[3] << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc == 4 && std::string(argv[1]) == "--bk-query") {
+        MappedBKTree tree;
+        if (!tree.open(argv[2])) {
+            std::cerr << "Не удалось открыть BK-дерево " << argv[2] << std::endl;
+            return 1;
+        }
+        std::vector<std::string> queries;
+        std::string query;
+        while (std::getline(std::cin, query)) queries.push_back(query);
+        for (const auto& matches : queryParallel(tree.view(), queries, std::stoll(argv[3]))) {
+            printMatches(matches);
+        }
+        return 0;
+    }
+    
+    // --mmap файлA файлB: строки читаются из файлов отображением в память
+    if (argc == 4 && std::string(argv[1]) == "--mmap") {
+        MappedFile fileA, fileB;
+        if (!fileA.open(argv[2]) || !fileB.open(argv[3])) {
+            std::cerr << "Не удалось открыть " << argv[2] << " или " << argv[3] << std::endl;
+            return 1;
+        }
+        std::cout << levenshteinDistance(fileA.sequence(), fileB.sequence()) << std::endl;
+        return 0;
+    }
+    
     std::string s, t;
     std::getline(std::cin, s);
     std::getline(std::cin, t);
@@ -1,6 +1,12 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 #define DEBUG
 using namespace std;
 
@@ -35,10 +41,10 @@ vector<size_t> prefix_function(const string& x) {
 }
 
 
-vector<size_t> kmp_search(const string& needle, const string& haystack) {
+// lps - уже посчитанная префикс-функция needle
+vector<size_t> kmp_search(const string& needle, const string& haystack, const vector<size_t>& lps) {
     size_t n = haystack.length();
     size_t m = needle.length(); 
-    vector<size_t> lps = prefix_function(needle);
     vector<size_t> occurrences;
     size_t i = 0;
     size_t j = 0;
@@ -69,11 +75,184 @@ vector<size_t> kmp_search(const string& needle, const string& haystack) {
 }
 
 
+vector<size_t> kmp_search(const string& needle, const string& haystack) {
+    return kmp_search(needle, haystack, prefix_function(needle));
+}
+
+
+// Автомат КМП: префикс-функция заранее разворачивается в полную таблицу
+// переходов, и каждый символ текста стоит ровно одного чтения таблицы, без
+// цикла откатов по lps. Алфавит сжат: символы шаблона получают классы
+// 1..k, все остальные - общий класс 0, так что строка таблицы занимает
+// k + 1 ячеек, а не 256. В таблице хранится сразу смещение строки
+// (состояние * число классов), умножение в цикле поиска не нужно.
+struct kmp_automaton {
+    array<uint16_t, 256> symbol_class{};
+    size_t classes = 1;
+    vector<uint32_t> next;   // next[состояние * classes + класс] - смещение строки следующего состояния
+    uint32_t accept = 0;     // смещение строки состояния m (найдено вхождение)
+};
+
+// больше ячеек таблица не занимает (16 МБ), для длинных шаблонов
+// с большим алфавитом остается обычный kmp_search
+const size_t MAX_DFA_CELLS = size_t(1) << 22;
+
+
+bool build_kmp_automaton(const string& needle, const vector<size_t>& lps, kmp_automaton& dfa) {
+    size_t m = needle.length();
+    if (m == 0) return false;
+
+    for (unsigned char c : needle) {
+        if (!dfa.symbol_class[c]) dfa.symbol_class[c] = dfa.classes++;
+    }
+    if ((m + 1) * dfa.classes > MAX_DFA_CELLS) return false;
+
+    size_t k = dfa.classes;
+    dfa.next.assign((m + 1) * k, 0);
+    dfa.accept = m * k;
+
+    for (size_t q = 0; q <= m; q++) {
+        // из состояния q переход такой же, как из длины совпадающего
+        // префикса/суффикса, кроме продолжения шаблона символом needle[q]
+        size_t fallback = q == 0 ? 0 : lps[q - 1];
+        for (size_t c = 0; c < k; c++) {
+            dfa.next[q * k + c] = q == 0 ? 0 : dfa.next[fallback * k + c];
+        }
+        if (q < m) dfa.next[q * k + dfa.symbol_class[(unsigned char)needle[q]]] = (q + 1) * k;
+    }
+    return true;
+}
+
+
+// Проход автомата по haystack с позиции from из начального состояния:
+// находит все вхождения, начинающиеся не раньше from
+void kmp_automaton_scan(const kmp_automaton& dfa, size_t m, const string& haystack, size_t from,
+                        vector<size_t>& occurrences) {
+    size_t n = haystack.length();
+    const uint32_t* next = dfa.next.data();
+    uint32_t state = 0;
+
+    for (size_t i = from; i < n; i++) {
+        state = next[state + dfa.symbol_class[(unsigned char)haystack[i]]];
+        if (state == dfa.accept) {
+#ifdef DEBUG
+            cout << "Нашли совпадение по индексу: " << i + 1 - m << endl;
+#endif
+            occurrences.push_back(i + 1 - m);
+        }
+    }
+}
+
+
+// Поиск всех вхождений автоматом; если таблица не помещается в
+// MAX_DFA_CELLS, используется kmp_search с откатами по lps
+vector<size_t> kmp_dfa_search(const string& needle, const string& haystack) {
+    vector<size_t> lps = prefix_function(needle);
+    kmp_automaton dfa;
+    if (!build_kmp_automaton(needle, lps, dfa)) return kmp_search(needle, haystack, lps);
+
+    vector<size_t> occurrences;
+    kmp_automaton_scan(dfa, needle.length(), haystack, 0, occurrences);
+    return occurrences;
+}
+
+
+// Фильтр кандидатов перед проверкой: вхождение может начинаться только в
+// позиции p, где haystack[p] == needle[0] и haystack[p + m - 1] == needle[m - 1].
+// Оба сравнения делаются векторно сразу для 32 (AVX2) или 16 (SSE2) позиций,
+// без SIMD кандидаты по первому символу ищет memchr. Уцелевшие позиции
+// проверяются memcmp середины шаблона.
+//
+// Если кандидатов слишком много (частые символы, маленький алфавит),
+// проверка за O(m) на кандидата перестает окупаться, и остаток текста
+// проходит автомат КМП - общее время остается линейным
+vector<size_t> prefiltered_search(const string& needle, const string& haystack) {
+    size_t n = haystack.length();
+    size_t m = needle.length();
+    if (m == 0) return kmp_search(needle, haystack);
+    // префикс-функция считается до поиска, как в kmp_search: с DEBUG ее
+    // вывод всегда идет перед найденными вхождениями
+    vector<size_t> lps = prefix_function(needle);
+    if (m > n) return {};
+
+    const char* text = haystack.data();
+    const char first = needle[0], last = needle[m - 1];
+    const size_t starts = n - m + 1;   // число возможных позиций начала
+    vector<size_t> occurrences;
+    size_t verify_cost = 0;            // байт проверено с учетом накладных расходов на кандидата
+
+    auto verify = [&](size_t p) {
+        verify_cost += m + 16;
+        if (m <= 2 || memcmp(text + p + 1, needle.data() + 1, m - 2) == 0) {
+#ifdef DEBUG
+            cout << "Нашли совпадение по индексу: " << p << endl;
+#endif
+            occurrences.push_back(p);
+        }
+    };
+    // проверка дороже двух проходов по уже отфильтрованному тексту
+    auto too_many_candidates = [&](size_t p) {
+        return verify_cost > 2 * p + 65536;
+    };
+    // остаток текста с позиции p проходит автомат; если таблица слишком
+    // велика, проверка кандидатов продолжается без повторных попыток
+    bool automaton_allowed = true;
+    auto switch_to_automaton = [&](size_t p) {
+        if (!automaton_allowed) return false;
+        automaton_allowed = false;
+        kmp_automaton dfa;
+        if (!build_kmp_automaton(needle, lps, dfa)) return false;
+        kmp_automaton_scan(dfa, m, haystack, p, occurrences);
+        return true;
+    };
+
+    size_t p = 0;
+#if defined(__AVX2__)
+    const __m256i first_block = _mm256_set1_epi8(first), last_block = _mm256_set1_epi8(last);
+    for (; p + 32 <= starts; p += 32) {
+        __m256i head = _mm256_loadu_si256((const __m256i*)(text + p));
+        __m256i tail = _mm256_loadu_si256((const __m256i*)(text + p + m - 1));
+        uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(head, first_block),
+                                                              _mm256_cmpeq_epi8(tail, last_block)));
+        while (mask) {
+            verify(p + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+        if (too_many_candidates(p) && switch_to_automaton(p + 32)) return occurrences;
+    }
+#elif defined(__SSE2__)
+    const __m128i first_block = _mm_set1_epi8(first), last_block = _mm_set1_epi8(last);
+    for (; p + 16 <= starts; p += 16) {
+        __m128i head = _mm_loadu_si128((const __m128i*)(text + p));
+        __m128i tail = _mm_loadu_si128((const __m128i*)(text + p + m - 1));
+        uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, first_block),
+                                                        _mm_cmpeq_epi8(tail, last_block)));
+        while (mask) {
+            verify(p + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+        if (too_many_candidates(p) && switch_to_automaton(p + 16)) return occurrences;
+    }
+#endif
+
+    // хвост текста (или весь текст без SIMD): следующий кандидат по первому символу
+    while (p < starts) {
+        const char* found = (const char*)memchr(text + p, first, starts - p);
+        if (!found) break;
+        p = found - text;
+        if (text[p + m - 1] == last) verify(p);
+        p++;
+        if (too_many_candidates(p) && switch_to_automaton(p)) return occurrences;
+    }
+    return occurrences;
+}
+
+
 int main() {
     string needle, haystack;
     cin >> needle >> haystack;
 
-    vector<size_t> occurrences = kmp_search(needle, haystack);
+    vector<size_t> occurrences = prefiltered_search(needle, haystack);
 
     if (occurrences.empty()) {
         cout << -1 << endl;